@@ -34,9 +34,13 @@
 #include <bitcoin/blockchain/pools/block_pool.hpp>
 #include <bitcoin/blockchain/pools/header_branch.hpp>
 #include <bitcoin/blockchain/pools/header_entry.hpp>
+#include <bitcoin/blockchain/pools/header_index.hpp>
 #include <bitcoin/blockchain/pools/header_pool.hpp>
+#include <bitcoin/blockchain/pools/header_window.hpp>
 #include <bitcoin/blockchain/pools/transaction_entry.hpp>
+#include <bitcoin/blockchain/pools/transaction_filter.hpp>
 #include <bitcoin/blockchain/pools/transaction_pool.hpp>
+#include <bitcoin/blockchain/pools/utxo_cache.hpp>
 #include <bitcoin/blockchain/pools/utilities/anchor_converter.hpp>
 #include <bitcoin/blockchain/pools/utilities/child_closure_calculator.hpp>
 #include <bitcoin/blockchain/pools/utilities/conflicting_spend_remover.hpp>
@@ -50,6 +54,8 @@
 #include <bitcoin/blockchain/populate/populate_chain_state.hpp>
 #include <bitcoin/blockchain/populate/populate_header.hpp>
 #include <bitcoin/blockchain/populate/populate_transaction.hpp>
+#include <bitcoin/blockchain/validate/metrics_cache.hpp>
+#include <bitcoin/blockchain/validate/script_cache.hpp>
 #include <bitcoin/blockchain/validate/validate_block.hpp>
 #include <bitcoin/blockchain/validate/validate_header.hpp>
 #include <bitcoin/blockchain/validate/validate_input.hpp>
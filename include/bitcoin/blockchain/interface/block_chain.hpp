@@ -35,10 +35,17 @@
 #include <bitcoin/blockchain/organizers/organize_transaction.hpp>
 #include <bitcoin/blockchain/pools/block_pool.hpp>
 #include <bitcoin/blockchain/pools/header_branch.hpp>
+#include <bitcoin/blockchain/pools/header_index.hpp>
 #include <bitcoin/blockchain/pools/header_pool.hpp>
+#include <bitcoin/blockchain/pools/header_window.hpp>
+#include <bitcoin/blockchain/pools/transaction_filter.hpp>
 #include <bitcoin/blockchain/pools/transaction_pool.hpp>
+#include <bitcoin/blockchain/pools/utxo_cache.hpp>
 #include <bitcoin/blockchain/populate/populate_chain_state.hpp>
 #include <bitcoin/blockchain/settings.hpp>
+#include <bitcoin/blockchain/validate/metrics_cache.hpp>
+#include <bitcoin/blockchain/validate/script_cache.hpp>
+#include <boost/filesystem.hpp>
 
 namespace libbitcoin {
 namespace blockchain {
@@ -426,6 +433,9 @@ public:
     /// Organize a header into the candidate chain and organize accordingly.
     void organize(system::header_const_ptr header, result_handler handler);
 
+    /// Organize a contiguous run of headers with a single reorganization.
+    void organize(system::headers_const_ptr headers, result_handler handler);
+
     /// Store a transaction to the pool.
     void organize(system::transaction_const_ptr tx, result_handler handler);
 
@@ -496,6 +506,9 @@ protected:
     // Neutrino filter metadata populator.
     system::code populate_neutrino_filters(
         system::block_const_ptr_list_const_ptr blocks) const;
+    void compute_neutrino_filters(system::block_const_ptr_list_const_ptr blocks,
+        std::shared_ptr<system::data_stack> filters, size_t bucket,
+        size_t buckets, result_handler handler) const;
 
     // This is protected by mutex.
     database::data_base database_;
@@ -503,6 +516,8 @@ protected:
     // Made protected for testing.
     system::atomic<system::transaction_const_ptr> last_pool_transaction_;
     virtual void catalog_transaction(system::transaction_const_ptr tx);
+    bool load_snapshot();
+    bool save_snapshot() const;
 
 private:
     // Properties.
@@ -515,6 +530,12 @@ private:
     bool set_top_candidate_state();
     bool set_top_valid_candidate_state();
     bool set_next_confirmed_state();
+    bool set_transaction_filter();
+    bool set_header_index(bool candidate);
+    bool set_header_window(bool candidate);
+
+    bool load_transaction_filter();
+    bool save_transaction_filter() const;
 
     bool set_neutrino_filter_checkpoints();
     bool update_neutrino_filter_checkpoints(size_t fork_height,
@@ -534,9 +555,14 @@ private:
         const database::block_result& result, bool witness) const;
     bool get_transaction_hashes(system::hash_list& out_hashes,
         const database::block_result& result) const;
+    bool add_transaction_hashes(size_t height, bool candidate);
+    void pop_headers(size_t fork_height, bool candidate);
+    void push_header(const system::chain::header& header, size_t height,
+        bool candidate);
 
     // These are thread safe.
     std::atomic<bool> stopped_;
+    std::atomic<bool> initialized_;
 
     system::atomic<system::config::checkpoint> fork_point_;
     system::atomic<system::uint256_t> candidate_work_;
@@ -548,6 +574,8 @@ private:
 
     const settings& settings_;
     const system::settings& bitcoin_settings_;
+    const boost::filesystem::path snapshot_path_;
+    const boost::filesystem::path transaction_filter_path_;
     const populate_chain_state chain_state_populator_;
 
     mutable system::upgrade_mutex candidate_mutex_;
@@ -555,9 +583,18 @@ private:
     mutable system::threadpool priority_pool_;
     mutable system::dispatcher priority_dispatch_;
 
-    // The block pool is strictly a cache, so mutable.
+    // The block pool and utxo cache are strictly caches, so mutable.
     header_pool header_pool_;
     mutable block_pool block_pool_;
+    mutable utxo_cache utxo_cache_;
+    transaction_filter transaction_filter_;
+
+    header_index candidate_index_;
+    header_index confirmed_index_;
+    header_window candidate_window_;
+    header_window confirmed_window_;
+    script_cache script_cache_;
+    metrics_cache metrics_cache_;
     transaction_pool transaction_pool_;
 
     organize_header organize_header_;
@@ -217,6 +217,8 @@ public:
 
     virtual void organize(system::header_const_ptr header,
         result_handler handler) = 0;
+    virtual void organize(system::headers_const_ptr headers,
+        result_handler handler) = 0;
     virtual void organize(system::transaction_const_ptr tx,
         result_handler handler) = 0;
     virtual system::code organize(system::block_const_ptr block,
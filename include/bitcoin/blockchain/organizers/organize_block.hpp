@@ -28,6 +28,8 @@
 #include <bitcoin/blockchain/interface/fast_chain.hpp>
 #include <bitcoin/blockchain/pools/block_pool.hpp>
 #include <bitcoin/blockchain/settings.hpp>
+#include <bitcoin/blockchain/validate/metrics_cache.hpp>
+#include <bitcoin/blockchain/validate/script_cache.hpp>
 #include <bitcoin/blockchain/validate/validate_block.hpp>
 
 namespace libbitcoin {
@@ -46,7 +48,8 @@ public:
     /// Construct an instance.
     organize_block(system::prioritized_mutex& mutex,
         system::dispatcher& priority_dispatch, system::threadpool& threads,
-        fast_chain& chain, block_pool& pool, const settings& settings,
+        fast_chain& chain, block_pool& pool, const script_cache& cache,
+        const metrics_cache& metrics, const settings& settings,
         const system::settings& bitcoin_settings);
 
     /// Start/stop the organizer.
@@ -61,6 +64,13 @@ public:
 
 protected:
     bool stopped() const;
+    bool defer(size_t height, size_t branch_size) const;
+
+    // Pipeline sub-sequence.
+    system::code accept(system::block_const_ptr block);
+    void speculate(system::block_const_ptr parent, size_t height);
+    void settle();
+    void rollback();
 
 private:
     // TODO: create common definitions.
@@ -68,6 +78,24 @@ private:
     typedef std::shared_ptr<system::block_const_ptr_list>
         block_const_ptr_list_ptr;
 
+    // A successor block accepted while its parent is being connected.
+    struct speculation
+    {
+        system::block_const_ptr parent;
+        system::block_const_ptr block;
+        size_t height;
+        system::config::checkpoint fork_point;
+        std::promise<system::code> accepted;
+        std::future<system::code> complete;
+
+        // Check results of the block, restored upon rollback.
+        system::code error;
+        bool validated;
+        system::chain::chain_state::ptr state;
+    };
+
+    typedef std::shared_ptr<speculation> speculation_ptr;
+
     // Validate sequence.
     void handle_complete(const system::code& ec);
     void block_fetcher(size_t height, const system::hash_digest& parent_hash,
@@ -75,16 +103,20 @@ private:
     void handle_fetch(const system::code& ec, system::block_const_ptr block,
         size_t height, const system::hash_digest& parent_hash,
         block_const_ptr_list_ptr sub_branch, result_handler complete);
+    bool is_candidate(system::block_const_ptr block, size_t height) const;
 
     // Validate sub-sequence.
-    system::code validate(system::block_const_ptr block);
+    system::code validate(system::block_const_ptr block, size_t height);
+    system::code connect(system::block_const_ptr block);
     bool handle_check(const system::code& ec, size_t height);
-    void handle_accept(const system::code& ec, system::block_const_ptr block,
-        result_handler handler);
+    void handle_accept(const system::code& ec, result_handler handler);
     void handle_connect(const system::code& ec, system::block_const_ptr block,
         result_handler handler);
     void signal_completion(const system::code& ec);
 
+    // Pipeline sub-sequence.
+    void handle_speculated(const system::code& ec, speculation_ptr next);
+
     // These are thread safe.
     fast_chain& fast_chain_;
     system::prioritized_mutex& mutex_;
@@ -95,6 +127,12 @@ private:
     system::dispatcher& dispatch_;
     validate_block validator_;
     download_subscriber::ptr downloader_subscriber_;
+    const bool pipeline_;
+    const size_t reorganize_batch_;
+    const system::config::checkpoint::list& checkpoints_;
+
+    // This is protected by the sequential validation of blocks.
+    speculation_ptr next_;
 };
 
 } // namespace blockchain
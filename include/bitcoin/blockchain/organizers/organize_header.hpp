@@ -20,6 +20,8 @@
 #define LIBBITCOIN_BLOCKCHAIN_ORGANIZE_HEADER_HPP
 
 #include <atomic>
+#include <cstddef>
+#include <future>
 #include <memory>
 #include <bitcoin/system.hpp>
 #include <bitcoin/blockchain/define.hpp>
@@ -52,21 +54,35 @@ public:
     /// validate and organize a header into header pool and store.
     void organize(system::header_const_ptr header, result_handler handler);
 
+    /// validate and organize a contiguous run of headers (one reorganize).
+    void organize(system::headers_const_ptr headers, result_handler handler);
+
 protected:
     bool stopped() const;
 
 private:
+    void handle_check(const system::code& ec,
+        system::header_const_ptr_list_const_ptr run, result_handler handler);
+
     // Verify sub-sequence.
     void handle_accept(const system::code& ec, header_branch::ptr branch,
         result_handler handler);
     void handle_complete(const system::code& ec, result_handler handler);
 
+    // Utilities.
+    system::code accept(header_branch::ptr branch);
+    system::code commit(header_branch::ptr branch, size_t unpooled);
+    void signal_completion(const system::code& ec);
+
     // These are thread safe.
     fast_chain& fast_chain_;
     system::shared_mutex& mutex_;
     std::atomic<bool> stopped_;
     header_pool& pool_;
     validate_header validator_;
+
+    // This is protected by mutex.
+    std::promise<system::code> resume_;
 };
 
 } // namespace blockchain
@@ -30,6 +30,8 @@
 #include <bitcoin/blockchain/interface/safe_chain.hpp>
 #include <bitcoin/blockchain/pools/transaction_pool.hpp>
 #include <bitcoin/blockchain/settings.hpp>
+#include <bitcoin/blockchain/validate/metrics_cache.hpp>
+#include <bitcoin/blockchain/validate/script_cache.hpp>
 #include <bitcoin/blockchain/validate/validate_transaction.hpp>
 
 namespace libbitcoin {
@@ -48,7 +50,8 @@ public:
     /// Construct an instance.
     organize_transaction(system::prioritized_mutex& mutex,
         system::dispatcher& priority_dispatch, system::threadpool& threads,
-        fast_chain& chain, transaction_pool& pool, const settings& settings);
+        fast_chain& chain, transaction_pool& pool, script_cache& cache,
+        metrics_cache& metrics, const settings& settings);
 
     // Start/stop the organizer.
     bool start();
@@ -77,6 +80,7 @@ private:
     std::promise<system::code> resume_;
     const settings& settings_;
     transaction_pool& pool_;
+    metrics_cache& metrics_cache_;
     validate_transaction validator_;
 };
 
@@ -65,6 +65,9 @@ public:
     /// Get a block from the pool if cached otherwise from store if found.
     system::block_const_ptr get(size_t height);
 
+    /// Remove and return a block only if cached, never reads or waits.
+    system::block_const_ptr take(size_t height);
+
     /// Fetch a block from the pool, reading it from store as required.
     /// Handler returns success code with empty pointer if not found.
     void fetch(size_t height, read_handler&& handler);
@@ -83,6 +86,7 @@ protected:
 
     bool stopped() const;
     void read_block(size_t height);
+    void prefetch(system::block_const_ptr block) const;
     bool handle_add(const system::code& ec, system::block_const_ptr block,
         size_t height, size_t target_height, read_handler handler) const;
 
@@ -35,6 +35,10 @@ public:
     /// Construct an entry for the pool.
     header_entry(system::header_const_ptr header, size_t height);
 
+    /// Construct an entry for the pool with branch work and insertion order.
+    header_entry(system::header_const_ptr header, size_t height,
+        const system::uint256_t& work, size_t sequence);
+
     /// Use this construction only as a search key.
     header_entry(const system::hash_digest& hash);
 
@@ -44,6 +48,12 @@ public:
     /// The height of the header the entry contains.
     size_t height() const;
 
+    /// The cumulative work of the pooled branch up to and including header.
+    const system::uint256_t& work() const;
+
+    /// The insertion order of the entry.
+    size_t sequence() const;
+
     /// The hash table entry identity.
     const system::hash_digest& hash() const;
 
@@ -56,6 +66,9 @@ public:
     /// Add header to the list of children of this header.
     void add_child(system::header_const_ptr child) const;
 
+    /// Remove hash from the list of children of this header.
+    void remove_child(const system::hash_digest& child) const;
+
     /// Operators.
     bool operator==(const header_entry& other) const;
 
@@ -65,6 +78,8 @@ public:
 private:
     // These are non-const to allow for default copy construction.
     size_t height_;
+    size_t sequence_;
+    system::uint256_t work_;
     system::hash_digest hash_;
     system::header_const_ptr header_;
 
@@ -0,0 +1,88 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_BLOCKCHAIN_HEADER_INDEX_HPP
+#define LIBBITCOIN_BLOCKCHAIN_HEADER_INDEX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <bitcoin/system.hpp>
+#include <bitcoin/blockchain/define.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+/// This class is thread safe.
+/// An in-memory copy of the chain state fields of all headers of an index
+/// (candidate or confirmed), from genesis, as parallel arrays by height.
+/// Cumulative work is also indexed, so that work above a height is computed
+/// in constant time and the overcome limit by binary search.
+/// Headers must be popped before the index is changed in the store, and
+/// pushed after. A push that is not contiguous with the top is ignored.
+class BCB_API header_index
+{
+public:
+    header_index();
+
+    /// The number of headers in the index (top height + 1).
+    size_t size() const;
+
+    /// Reserve space for the given number of headers.
+    void reserve(size_t size);
+
+    /// Get fields of the header at the given height, false if not present.
+    bool get_block_hash(system::hash_digest& out_hash, size_t height) const;
+    bool get_bits(uint32_t& out_bits, size_t height) const;
+    bool get_version(uint32_t& out_version, size_t height) const;
+    bool get_timestamp(uint32_t& out_timestamp, size_t height) const;
+
+    /// Sum the proof of headers above the given height, to the top, or
+    /// until overcome is reached (zero for no limit). False if top is not
+    /// the top of the index.
+    bool get_work(system::uint256_t& out_work,
+        const system::uint256_t& overcome, size_t above_height,
+        size_t top) const;
+
+    /// Remove all headers above the fork height.
+    void pop(size_t fork_height);
+
+    /// Add the header at the given height as the top of the index.
+    void push(const system::chain::header& header, size_t height);
+
+    /// Serialize the index (for snapshot), work is not serialized.
+    void to_data(system::writer& sink) const;
+
+    /// Deserialize an index and recompute its work, false (and empty) if
+    /// the data is invalid.
+    bool from_data(system::reader& source);
+
+private:
+    // These are protected by mutex.
+    std::vector<system::hash_digest> hashes_;
+    std::vector<uint32_t> bits_;
+    std::vector<uint32_t> versions_;
+    std::vector<uint32_t> timestamps_;
+    std::vector<system::uint256_t> work_;
+    mutable system::upgrade_mutex mutex_;
+};
+
+} // namespace blockchain
+} // namespace libbitcoin
+
+#endif
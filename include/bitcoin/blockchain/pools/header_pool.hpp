@@ -19,7 +19,10 @@
 #ifndef LIBBITCOIN_BLOCKCHAIN_HEADER_POOL_HPP
 #define LIBBITCOIN_BLOCKCHAIN_HEADER_POOL_HPP
 
+#include <atomic>
 #include <cstddef>
+#include <set>
+#include <tuple>
 #include <bitcoin/system.hpp>
 #include <bitcoin/blockchain/define.hpp>
 #include <bitcoin/blockchain/pools/header_branch.hpp>
@@ -42,10 +45,17 @@ public:
     /// The number of headers in the pool.
     size_t size() const;
 
+    /// The estimated number of bytes used by headers in the pool, including
+    /// the chain state retained by each branch tip.
+    size_t bytes() const;
+
+    /// The number of headers evicted to bound the pool to its byte budget.
+    size_t evictions() const;
+
     /// The header exists in the pool.
     bool exists(system::header_const_ptr header) const;
 
-    /// Add newly-validated header.
+    /// Add newly-validated header, evicting the weakest tips if over budget.
     void add(system::header_const_ptr valid_header, size_t height);
 
     /// Add root path of reorganized headers (no branches).
@@ -56,6 +66,7 @@ public:
     void remove(system::header_const_ptr_list_const_ptr accepted_headers);
 
     /// Purge branch rooted below top minus maximum depth.
+    /// This visits only expired roots and their descendants.
     void prune(size_t top_height);
 
     /// Remove all message vectors that match header hashes.
@@ -69,10 +80,18 @@ public:
 protected:
     // A bidirectional map is used for efficient header and position retrieval.
     // This produces the effect of a circular buffer hash table header forest.
+    // Roots are ordered by height and all non-root nodes have zero height.
     typedef boost::bimaps::bimap<
         boost::bimaps::unordered_set_of<header_entry>,
         boost::bimaps::multiset_of<size_t>> header_entries;
 
+    // Branch tips are ordered by cumulative work, then by insertion order.
+    typedef std::tuple<system::uint256_t, size_t, system::hash_digest> tip;
+    typedef std::set<tip> tips;
+
+    static tip to_tip(const header_entry& entry);
+
+    bool evict();
     bool exists(const system::hash_digest& hash) const;
     void prune(const system::hash_list& hashes, size_t minimum_height);
     system::header_const_ptr parent(system::header_const_ptr header) const;
@@ -81,11 +100,17 @@ protected:
 
     // This is thread safe.
     const size_t maximum_depth_;
+    const size_t maximum_bytes_;
+    std::atomic<size_t> evictions_;
 
     // This is guarded against filtering concurrent to writing.
     // All other operations are presumed to be externally protected.
     header_entries headers_;
     mutable system::upgrade_mutex mutex_;
+
+    // These are externally protected with the pool.
+    size_t sequence_;
+    tips tips_;
 };
 
 } // namespace blockchain
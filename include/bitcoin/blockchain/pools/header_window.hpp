@@ -0,0 +1,92 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_BLOCKCHAIN_HEADER_WINDOW_HPP
+#define LIBBITCOIN_BLOCKCHAIN_HEADER_WINDOW_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <bitcoin/system.hpp>
+#include <bitcoin/blockchain/define.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+/// This class is thread safe.
+/// A ring buffer of the chain state fields of the top headers of an index
+/// (candidate or confirmed). The window is contiguous by height, so a push
+/// that does not extend the top replaces the window. Entries must be popped
+/// before the index is changed in the store, and pushed after.
+class BCB_API header_window
+{
+public:
+    /// Construct a window of the given number of headers (zero disables).
+    header_window(size_t capacity);
+
+    /// The maximum number of headers in the window.
+    size_t capacity() const;
+
+    /// The number of headers in the window.
+    size_t size() const;
+
+    /// Get fields of the header at the given height, false if not present.
+    bool get_block_hash(system::hash_digest& out_hash, size_t height) const;
+    bool get_bits(uint32_t& out_bits, size_t height) const;
+    bool get_version(uint32_t& out_version, size_t height) const;
+    bool get_timestamp(uint32_t& out_timestamp, size_t height) const;
+
+    /// Remove all headers above the fork height.
+    void pop(size_t fork_height);
+
+    /// Add the header at the given height as the top of the window.
+    void push(const system::chain::header& header, size_t height);
+
+    /// Serialize the window (for snapshot).
+    void to_data(system::writer& sink) const;
+
+    /// Deserialize a window of the same capacity, false (and empty) if not.
+    bool from_data(system::reader& source);
+
+private:
+    struct entry
+    {
+        system::hash_digest hash;
+        uint32_t bits;
+        uint32_t version;
+        uint32_t timestamp;
+    };
+
+    typedef std::vector<entry> entries;
+
+    bool find(entry& out_entry, size_t height) const;
+
+    // This is thread safe.
+    const size_t capacity_;
+
+    // These are protected by mutex.
+    size_t top_;
+    size_t count_;
+    entries entries_;
+    mutable system::upgrade_mutex mutex_;
+};
+
+} // namespace blockchain
+} // namespace libbitcoin
+
+#endif
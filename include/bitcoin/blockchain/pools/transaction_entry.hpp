@@ -26,6 +26,7 @@
 #include <vector>
 #include <bitcoin/system.hpp>
 #include <bitcoin/blockchain/define.hpp>
+#include <bitcoin/blockchain/validate/metrics_cache.hpp>
 #include <boost/bimap.hpp>
 #include <boost/bimap/multiset_of.hpp>
 #include <boost/functional/hash_fwd.hpp>
@@ -61,6 +62,11 @@ public:
     /// double spend and input invalid due to forks change (sentinel forks).
     transaction_entry(system::transaction_const_ptr tx);
 
+    /// Construct an entry for the pool with size and sigops cached by fee
+    /// policy under the sigop rules of the tx state (see metrics_cache).
+    transaction_entry(system::transaction_const_ptr tx,
+        const metrics_cache::metrics& metrics);
+
     /// Use this construction only as a search key.
     transaction_entry(const system::hash_digest& hash);
 
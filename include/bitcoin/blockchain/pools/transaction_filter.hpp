@@ -0,0 +1,106 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_BLOCKCHAIN_TRANSACTION_FILTER_HPP
+#define LIBBITCOIN_BLOCKCHAIN_TRANSACTION_FILTER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <bitcoin/system.hpp>
+#include <bitcoin/blockchain/define.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+/// This class is thread safe.
+/// An approximate membership (cuckoo) filter over stored transaction hashes.
+/// A negative result is definite, so the store query may be skipped. Hashes
+/// are never removed, as stored transactions are never removed. If an add
+/// fails for lack of room the filter saturates, and is then always positive.
+/// A filter that may omit stored hashes must be saturated (advisory).
+class BCB_API transaction_filter
+{
+public:
+    /// Construct a filter of the given approximate size (zero disables).
+    transaction_filter(size_t maximum_bytes);
+
+    /// The number of hashes added.
+    size_t size() const;
+
+    /// The memory consumption of the filter.
+    size_t bytes() const;
+
+    /// True if disabled or full, in which case contains is always true.
+    bool saturated() const;
+
+    /// False if the hash has definitely not been added.
+    bool contains(const system::hash_digest& hash) const;
+
+    /// Add a hash, saturating the filter if there is no room.
+    void add(const system::hash_digest& hash);
+
+    /// Remove all hashes and clear saturation (unless disabled).
+    void clear();
+
+    /// Make contains always true until clear, for an incomplete filter.
+    void saturate();
+
+    /// Serialize the filter (for persistence).
+    void to_data(system::writer& sink) const;
+
+    /// Deserialize a filter of the same size, false (and unchanged) if not.
+    bool from_data(system::reader& source);
+
+    /// The estimated probability that contains is true for a hash not added.
+    double false_positive_rate() const;
+
+    /// The number of contains queries.
+    size_t queries() const;
+
+    /// The number of contains queries with a negative result.
+    size_t negatives() const;
+
+private:
+    typedef uint16_t fingerprint;
+    typedef std::vector<fingerprint> slots;
+
+    static fingerprint to_fingerprint(const system::hash_digest& hash);
+    size_t to_bucket(const system::hash_digest& hash) const;
+    size_t to_alternate(size_t bucket, fingerprint value) const;
+    bool find(size_t bucket, fingerprint value) const;
+    bool insert(size_t bucket, fingerprint value);
+
+    // These are thread safe.
+    const size_t buckets_;
+    mutable std::atomic<size_t> queries_;
+    mutable std::atomic<size_t> negatives_;
+
+    // These are protected by mutex.
+    size_t size_;
+    size_t kicks_;
+    bool saturated_;
+    slots slots_;
+    mutable system::upgrade_mutex mutex_;
+};
+
+} // namespace blockchain
+} // namespace libbitcoin
+
+#endif
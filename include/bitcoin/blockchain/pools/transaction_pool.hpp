@@ -27,6 +27,7 @@
 #include <bitcoin/blockchain/settings.hpp>
 #include <bitcoin/blockchain/pools/transaction_entry.hpp>
 #include <bitcoin/blockchain/pools/utilities/transaction_pool_state.hpp>
+#include <bitcoin/blockchain/validate/metrics_cache.hpp>
 #include <boost/bimap.hpp>
 #include <boost/bimap/multiset_of.hpp>
 #include <boost/bimap/unordered_set_of.hpp>
@@ -42,7 +43,7 @@ public:
     typedef safe_chain::merkle_block_fetch_handler merkle_block_fetch_handler;
     typedef double priority;
 
-    transaction_pool(const settings& settings);
+    transaction_pool(const settings& settings, metrics_cache& metrics);
 
     /// The tx exists in the pool.
     bool exists(system::transaction_const_ptr tx) const;
@@ -81,6 +82,7 @@ private:
     void update_template(priority_iterator max_pool_change);
 
 private:
+    metrics_cache& metrics_;
     transaction_pool_state state_;
 };
 
@@ -0,0 +1,132 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_BLOCKCHAIN_UTXO_CACHE_HPP
+#define LIBBITCOIN_BLOCKCHAIN_UTXO_CACHE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <bitcoin/system.hpp>
+#include <bitcoin/blockchain/define.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+/// This class is thread safe.
+/// A memory bounded cache of confirmed and unspent outputs, in front of the
+/// store. An output is removed when spent by a candidate or confirmed block,
+/// or when its confirming block is reorganized out. A cached output is only
+/// returned for population at or above its confirmation height, so that it
+/// is not visible to a candidate chain forked below it.
+class BCB_API utxo_cache
+{
+public:
+    /// Construct a cache of the given approximate size (zero disables).
+    utxo_cache(size_t maximum_bytes);
+
+    /// The number of cached outputs.
+    size_t size() const;
+
+    /// The approximate memory consumption of the cache.
+    size_t bytes() const;
+
+    /// Populate prevout metadata from the cache, false if not found.
+    bool populate(const system::chain::output_point& outpoint,
+        size_t fork_height) const;
+
+    /// The number of removal operations, obtain before reading the store.
+    size_t sequence() const;
+
+    /// Cache a prevout populated by the store if confirmed and unspent.
+    /// The prevout is not cached if there has been a removal since sequence,
+    /// as the store read may predate a spend or reorganization.
+    void add(const system::chain::output_point& outpoint, size_t fork_height,
+        size_t sequence);
+
+    /// Cache the outputs of a newly confirmed block at the given height.
+    /// Outputs spent within the block and unspendable outputs are skipped.
+    /// Header metadata median_time_past must be set.
+    void add(const system::chain::block& block, size_t height);
+
+    /// Remove outputs spent by the block.
+    void remove_spent(const system::chain::block& block);
+
+    /// Remove outputs created by the block (reorganized out).
+    void remove_created(const system::chain::block& block);
+
+    /// The number of successful populations.
+    size_t hits() const;
+
+    /// The number of unsuccessful populations.
+    size_t misses() const;
+
+private:
+    struct key
+    {
+        system::hash_digest hash;
+        uint32_t index;
+
+        bool operator==(const key& other) const;
+    };
+
+    struct key_hash
+    {
+        size_t operator()(const key& value) const;
+    };
+
+    typedef std::list<key> insertions;
+
+    struct entry
+    {
+        system::chain::output output;
+        size_t height;
+        uint32_t median_time_past;
+        bool coinbase;
+        bool candidate;
+        size_t bytes;
+        insertions::iterator position;
+    };
+
+    typedef std::unordered_map<key, entry, key_hash> entries;
+
+    static key to_key(const system::chain::point& point);
+    static size_t to_bytes(const system::chain::output& output);
+
+    void insert(const key& value, entry&& item);
+    void erase(const key& value);
+
+    // These are thread safe.
+    const size_t maximum_bytes_;
+    mutable std::atomic<size_t> hits_;
+    mutable std::atomic<size_t> misses_;
+
+    // These are protected by mutex.
+    size_t bytes_;
+    size_t removals_;
+    entries entries_;
+    insertions insertions_;
+    mutable system::upgrade_mutex mutex_;
+};
+
+} // namespace blockchain
+} // namespace libbitcoin
+
+#endif
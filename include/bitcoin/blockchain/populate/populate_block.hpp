@@ -20,6 +20,8 @@
 #define LIBBITCOIN_BLOCKCHAIN_POPULATE_BLOCK_HPP
 
 #include <cstddef>
+#include <memory>
+#include <vector>
 #include <bitcoin/system.hpp>
 #include <bitcoin/blockchain/define.hpp>
 #include <bitcoin/blockchain/interface/fast_chain.hpp>
@@ -41,14 +43,35 @@ public:
     void populate(system::block_const_ptr block,
         result_handler&& handler) const;
 
+    /// Populate validation state for a block given its parent's state.
+    void populate(system::block_const_ptr block,
+        system::chain::chain_state::ptr parent,
+        result_handler&& handler) const;
+
+    /// Refresh block metadata that depends on the (since committed) parent.
+    /// Returns true if any transaction or prevout metadata was refreshed.
+    bool repopulate(system::block_const_ptr block,
+        system::block_const_ptr parent) const;
+
 protected:
+    // Block prevouts of a common parent tx, ordered by output index so that
+    // duplicated outpoints are adjacent.
+    typedef std::vector<const system::chain::output_point*> prevout_group;
+    typedef std::vector<prevout_group> prevout_groups;
+    typedef std::shared_ptr<const prevout_groups> prevout_groups_ptr;
+
+    static prevout_groups_ptr group_prevouts(system::block_const_ptr block);
+    static void populate_internal(const system::chain::output_point& prevout,
+        const system::chain::transaction& parent, bool coinbase,
+        const system::chain::chain_state& state);
+
     void populate_coinbase(system::block_const_ptr block,
         size_t fork_height) const;
     void populate_non_coinbase(system::block_const_ptr block,
         size_t fork_height, bool use_txs, result_handler handler) const;
     void populate_transactions(system::block_const_ptr block,
-        size_t fork_height, size_t bucket, size_t buckets, bool populate_txs,
-        result_handler handler) const;
+        prevout_groups_ptr groups, size_t fork_height, size_t bucket,
+        size_t buckets, bool populate_txs, result_handler handler) const;
 
 private:
     const bool catalog_;
@@ -40,6 +40,8 @@ public:
 
 private:
     bool set_branch_state(header_branch::ptr branch) const;
+    system::chain::chain_state::ptr rebuild_state(
+        header_branch::const_ptr branch) const;
 };
 
 } // namespace blockchain
@@ -41,6 +41,7 @@ public:
     uint32_t cores;
     bool priority;
     bool index_payments;
+    bool index_headers;
     bool use_libconsensus;
     float byte_fee_satoshis;
     float sigop_fee_satoshis;
@@ -48,7 +49,15 @@ public:
     uint32_t notify_limit_hours;
     uint32_t reorganization_limit;
     uint32_t block_buffer_limit;
+    uint32_t script_cache_limit;
+    uint32_t metrics_cache_limit;
+    uint64_t utxo_cache_bytes;
+    uint64_t transaction_filter_bytes;
+    bool transaction_filter_rebuild;
+    uint64_t header_pool_bytes;
+    bool pipeline_validation;
     system::config::checkpoint::list checkpoints;
+    system::config::checkpoint assume_valid;
     bool difficult;
     bool retarget;
     bool bip16;
@@ -0,0 +1,102 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_BLOCKCHAIN_METRICS_CACHE_HPP
+#define LIBBITCOIN_BLOCKCHAIN_METRICS_CACHE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+#include <bitcoin/system.hpp>
+#include <bitcoin/blockchain/define.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+/// This class is thread safe.
+/// A bounded map of transaction size and signature operation counts.
+/// Transactions are identified by witness tx hash and the sigop rules, so
+/// that metrics computed for fee policy are reused by block validation.
+class BCB_API metrics_cache
+{
+public:
+    struct metrics
+    {
+        size_t size;
+        size_t sigops;
+    };
+
+    /// Construct a cache of the given number of transactions (zero disables).
+    metrics_cache(size_t maximum_size);
+
+    /// The number of cached transactions.
+    size_t size() const;
+
+    /// True if metrics of the tx are cached under the given sigop rules.
+    bool find(metrics& out_metrics, const system::chain::transaction& tx,
+        bool bip16, bool bip141) const;
+
+    /// Compute tx metrics (canonical size) and cache them under the rules.
+    /// Cached metrics are returned if present. When full the oldest
+    /// transaction is evicted.
+    metrics add(const system::message::transaction& tx, bool bip16,
+        bool bip141);
+
+    /// The number of successful finds.
+    size_t hits() const;
+
+    /// The number of unsuccessful finds.
+    size_t misses() const;
+
+private:
+    struct key
+    {
+        system::hash_digest hash;
+        uint8_t rules;
+
+        bool operator==(const key& other) const;
+    };
+
+    struct key_hash
+    {
+        size_t operator()(const key& value) const;
+    };
+
+    typedef std::unordered_map<key, metrics, key_hash> entries;
+    typedef std::deque<key> insertions;
+
+    static key to_key(const system::chain::transaction& tx, bool bip16,
+        bool bip141);
+
+    // These are thread safe.
+    const size_t maximum_size_;
+    mutable std::atomic<size_t> hits_;
+    mutable std::atomic<size_t> misses_;
+
+    // These are protected by mutex.
+    entries entries_;
+    insertions insertions_;
+    mutable system::upgrade_mutex mutex_;
+};
+
+} // namespace blockchain
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,96 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_BLOCKCHAIN_SCRIPT_CACHE_HPP
+#define LIBBITCOIN_BLOCKCHAIN_SCRIPT_CACHE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <unordered_set>
+#include <bitcoin/system.hpp>
+#include <bitcoin/blockchain/define.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+/// This class is thread safe.
+/// A bounded set of transaction inputs with successfully verified scripts.
+/// Inputs are identified by witness tx hash, input index and fork flags, so
+/// that pool verification can be reused by block verification.
+class BCB_API script_cache
+{
+public:
+    /// Construct a cache of the given number of inputs (zero disables).
+    script_cache(size_t maximum_size);
+
+    /// The number of cached inputs.
+    size_t size() const;
+
+    /// True if the tx input script was verified under the given forks.
+    bool find(const system::chain::transaction& tx, uint32_t input_index,
+        uint32_t forks) const;
+
+    /// Record verification of the tx input script under the given forks.
+    /// When full the oldest input is evicted.
+    void add(const system::chain::transaction& tx, uint32_t input_index,
+        uint32_t forks);
+
+    /// The number of successful finds.
+    size_t hits() const;
+
+    /// The number of unsuccessful finds.
+    size_t misses() const;
+
+private:
+    struct key
+    {
+        system::hash_digest hash;
+        uint32_t index;
+        uint32_t forks;
+
+        bool operator==(const key& other) const;
+    };
+
+    struct key_hash
+    {
+        size_t operator()(const key& value) const;
+    };
+
+    typedef std::unordered_set<key, key_hash> entries;
+    typedef std::deque<key> insertions;
+
+    static key to_key(const system::chain::transaction& tx,
+        uint32_t input_index, uint32_t forks);
+
+    // These are thread safe.
+    const size_t maximum_size_;
+    mutable std::atomic<size_t> hits_;
+    mutable std::atomic<size_t> misses_;
+
+    // These are protected by mutex.
+    entries entries_;
+    insertions insertions_;
+    mutable system::upgrade_mutex mutex_;
+};
+
+} // namespace blockchain
+} // namespace libbitcoin
+
+#endif
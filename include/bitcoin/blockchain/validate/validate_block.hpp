@@ -23,12 +23,15 @@
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <vector>
 #include <bitcoin/system.hpp>
 #include <bitcoin/blockchain/define.hpp>
 #include <bitcoin/blockchain/interface/fast_chain.hpp>
 #include <bitcoin/blockchain/pools/header_branch.hpp>
 #include <bitcoin/blockchain/populate/populate_block.hpp>
 #include <bitcoin/blockchain/settings.hpp>
+#include <bitcoin/blockchain/validate/metrics_cache.hpp>
+#include <bitcoin/blockchain/validate/script_cache.hpp>
 
 namespace libbitcoin {
 namespace blockchain {
@@ -40,6 +43,7 @@ public:
     typedef system::handle0 result_handler;
 
     validate_block(system::dispatcher& dispatch, const fast_chain& chain,
+        const script_cache& cache, const metrics_cache& metrics,
         const settings& settings, const system::settings& bitcoin_settings);
 
     void start();
@@ -49,14 +53,43 @@ public:
     void accept(system::block_const_ptr block, result_handler handler) const;
     void connect(system::block_const_ptr block, result_handler handler) const;
 
+    /// Pipeline support, accept a block before its parent is committed.
+    void accept(system::block_const_ptr block,
+        system::chain::chain_state::ptr parent, result_handler handler) const;
+    void accept_populated(system::block_const_ptr block,
+        result_handler handler) const;
+    bool repopulate(system::block_const_ptr block,
+        system::block_const_ptr parent) const;
+
 protected:
     bool stopped() const;
     float hit_rate() const;
+    bool is_assumed_valid(size_t height) const;
 
 private:
     typedef std::atomic<size_t> atomic_counter;
     typedef std::shared_ptr<atomic_counter> atomic_counter_ptr;
 
+    // Set by the first worker to fail, signaling the others to stop.
+    typedef std::atomic<bool> cancel_flag;
+    typedef std::shared_ptr<cancel_flag> cancel_flag_ptr;
+
+    typedef std::shared_ptr<const system::data_chunk> data_ptr;
+
+    // An input of a block transaction, pending script verification.
+    struct input_task
+    {
+        const system::chain::transaction* tx;
+        uint32_t input_index;
+
+        // The tx wire serialization, shared by its inputs (libconsensus).
+        data_ptr tx_data;
+    };
+
+    // The flattened set of block inputs, claimed by workers in chunks.
+    typedef std::vector<input_task> input_tasks;
+    typedef std::shared_ptr<const input_tasks> input_tasks_ptr;
+
     void dump(const system::code& ec, const system::chain::transaction& tx,
         uint32_t input_index, uint32_t forks, size_t height) const;
 
@@ -64,13 +97,15 @@ private:
         system::block_const_ptr block, system::asio::time_point start_time,
         result_handler handler) const;
     void accept_transactions(system::block_const_ptr block, size_t bucket,
-        size_t buckets, atomic_counter_ptr sigops, bool bip16, bool bip141,
-        result_handler handler) const;
+        size_t buckets, atomic_counter_ptr sigops, cancel_flag_ptr cancel,
+        bool bip16, bool bip141, result_handler handler) const;
     void handle_accepted(const system::code& ec, system::block_const_ptr block,
         atomic_counter_ptr sigops, bool bip141,
         system::asio::time_point start_time, result_handler handler) const;
-    void connect_inputs(system::block_const_ptr block, uint32_t bucket,
-        uint32_t buckets, result_handler handler) const;
+    input_tasks_ptr connect_tasks(system::block_const_ptr block) const;
+    void connect_inputs(system::block_const_ptr block, input_tasks_ptr tasks,
+        atomic_counter_ptr cursor, cancel_flag_ptr cancel,
+        result_handler handler) const;
     void handle_connected(const system::code& ec,
         system::block_const_ptr block, system::asio::time_point start_time,
         result_handler handler) const;
@@ -79,7 +114,11 @@ private:
     std::atomic<bool> stopped_;
     const bool use_libconsensus_;
     const system::config::checkpoint::list& checkpoints_;
+    const system::config::checkpoint& assume_valid_;
+    const fast_chain& fast_chain_;
     system::dispatcher& priority_dispatch_;
+    const script_cache& script_cache_;
+    const metrics_cache& metrics_cache_;
     mutable atomic_counter hits_;
     mutable atomic_counter queries_;
     populate_block block_populator_;
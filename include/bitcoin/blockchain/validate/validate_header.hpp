@@ -20,6 +20,8 @@
 #define LIBBITCOIN_BLOCKCHAIN_VALIDATE_HEADER_HPP
 
 #include <atomic>
+#include <cstddef>
+#include <memory>
 #include <bitcoin/system.hpp>
 #include <bitcoin/blockchain/define.hpp>
 #include <bitcoin/blockchain/pools/header_branch.hpp>
@@ -41,12 +43,24 @@ public:
     void stop();
 
     system::code check(system::header_const_ptr block) const;
+    void check(system::header_const_ptr_list_const_ptr headers,
+        result_handler handler) const;
     void accept(header_branch::ptr branch, result_handler handler) const;
 
 protected:
     bool stopped() const;
 
 private:
+    typedef std::atomic<bool> cancel_flag;
+    typedef std::shared_ptr<cancel_flag> cancel_flag_ptr;
+
+    void check_headers(system::header_const_ptr_list_const_ptr headers,
+        size_t bucket, size_t buckets, cancel_flag_ptr cancel,
+        result_handler handler) const;
+    void handle_checked(const system::code& ec,
+        system::header_const_ptr_list_const_ptr headers, size_t buckets,
+        system::asio::time_point start_time, result_handler handler) const;
+
     void handle_populated(const system::code& ec, header_branch::ptr branch,
         result_handler handler) const;
 
@@ -55,6 +69,7 @@ private:
     populate_header header_populator_;
     const bool scrypt_;
     const system::settings& bitcoin_settings_;
+    system::dispatcher& dispatch_;
 };
 
 } // namespace blockchain
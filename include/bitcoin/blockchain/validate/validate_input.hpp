@@ -42,6 +42,12 @@ public:
 
     static system::code verify_script(const system::chain::transaction& tx,
         uint32_t input_index, uint32_t forks, bool use_libconsensus);
+
+    /// Verify using the tx wire serialization (with witness) shared by all
+    /// inputs of tx, which avoids reserializing tx for each libconsensus call.
+    static system::code verify_script(const system::chain::transaction& tx,
+        const system::data_chunk& tx_data, uint32_t input_index,
+        uint32_t forks, bool use_libconsensus);
 };
 
 } // namespace blockchain
@@ -21,10 +21,12 @@
 
 #include <atomic>
 #include <cstddef>
+#include <memory>
 #include <bitcoin/system.hpp>
 #include <bitcoin/blockchain/define.hpp>
 #include <bitcoin/blockchain/populate/populate_transaction.hpp>
 #include <bitcoin/blockchain/settings.hpp>
+#include <bitcoin/blockchain/validate/script_cache.hpp>
 
 namespace libbitcoin {
 namespace blockchain {
@@ -36,7 +38,7 @@ public:
     typedef system::handle0 result_handler;
 
     validate_transaction(system::dispatcher& dispatch, const fast_chain& chain,
-        const settings& settings);
+        script_cache& cache, const settings& settings);
 
     void start();
     void stop();
@@ -52,16 +54,24 @@ protected:
     bool stopped() const;
 
 private:
+    typedef std::shared_ptr<const system::data_chunk> data_ptr;
+
+    // Set by the first worker to fail, signaling the others to stop.
+    typedef std::atomic<bool> cancel_flag;
+    typedef std::shared_ptr<cancel_flag> cancel_flag_ptr;
+
     void handle_populated(const system::code& ec,
         system::transaction_const_ptr tx, result_handler handler) const;
-    void connect_inputs(system::transaction_const_ptr tx, uint32_t bucket,
-        uint32_t buckets, result_handler handler) const;
+    void connect_inputs(system::transaction_const_ptr tx,
+        data_ptr tx_data, uint32_t bucket, uint32_t buckets,
+        cancel_flag_ptr cancel, result_handler handler) const;
 
     // These are thread safe.
     std::atomic<bool> stopped_;
     ////const bool retarget_;
     const bool use_libconsensus_;
     system::dispatcher& dispatch_;
+    script_cache& script_cache_;
     populate_transaction transaction_populator_;
 };
 
@@ -22,6 +22,8 @@
 #include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <future>
+#include <iterator>
 #include <memory>
 #include <string>
 #include <utility>
@@ -41,14 +43,55 @@ using namespace std::placeholders;
 
 #define NAME "block_chain"
 
+// Increment on any change to the snapshot serialization.
+static constexpr uint32_t snapshot_version = 2;
+static const std::string snapshot_file = "chain_state_snapshot";
+
+// Increment on any change to the transaction filter serialization.
+static constexpr uint32_t transaction_filter_version = 1;
+static const std::string transaction_filter_file = "transaction_filter";
+
+static void write_checkpoint(writer& sink, const config::checkpoint& value)
+{
+    sink.write_hash(value.hash());
+    sink.write_8_bytes_little_endian(value.height());
+}
+
+static config::checkpoint read_checkpoint(reader& source)
+{
+    const auto hash = source.read_hash();
+    const auto height = source.read_8_bytes_little_endian();
+    return { hash, static_cast<size_t>(height) };
+}
+
+static void write_work(writer& sink, const uint256_t& work)
+{
+    data_chunk bytes;
+    boost::multiprecision::export_bits(work, std::back_inserter(bytes), 8);
+    sink.write_size_little_endian(bytes.size());
+    sink.write_bytes(bytes);
+}
+
+static uint256_t read_work(reader& source)
+{
+    uint256_t work;
+    const auto bytes = source.read_bytes(source.read_size_little_endian());
+    boost::multiprecision::import_bits(work, bytes.begin(), bytes.end(), 8);
+    return work;
+}
+
 block_chain::block_chain(threadpool& pool, const blockchain::settings& settings,
     const database::settings& database_settings,
     const system::settings& bitcoin_settings)
   : database_(database_settings, settings.index_payments, settings.bip158),
     stopped_(true),
+    initialized_(false),
     fork_point_({ null_hash, 0 }),
     settings_(settings),
     bitcoin_settings_(bitcoin_settings),
+    snapshot_path_(database_settings.directory / snapshot_file),
+    transaction_filter_path_(
+        database_settings.directory / transaction_filter_file),
     chain_state_populator_(*this, settings, bitcoin_settings),
     // block_pool_populator_(*this, settings)
 
@@ -57,7 +100,20 @@ block_chain::block_chain(threadpool& pool, const blockchain::settings& settings,
 
     header_pool_(settings),
     block_pool_(*this, settings),
-    transaction_pool_(settings),
+    utxo_cache_(domain_constrain<size_t>(settings.utxo_cache_bytes)),
+    transaction_filter_(
+        domain_constrain<size_t>(settings.transaction_filter_bytes)),
+
+    // Cover the chain state retarget window for branches below the top.
+    // The windows are not required if all headers are indexed.
+    candidate_window_(settings.index_headers ? 0 :
+        2u * bitcoin_settings.retargeting_interval()),
+    confirmed_window_(settings.index_headers ? 0 :
+        2u * bitcoin_settings.retargeting_interval()),
+
+    script_cache_(settings.script_cache_limit),
+    metrics_cache_(settings.metrics_cache_limit),
+    transaction_pool_(settings, metrics_cache_),
 
     // Create dispatcher for priority operations.
     priority_pool_(
@@ -67,9 +123,10 @@ block_chain::block_chain(threadpool& pool, const blockchain::settings& settings,
     organize_header_(candidate_mutex_, priority_dispatch_, pool, *this,
         header_pool_, settings, bitcoin_settings),
     organize_block_(confirmation_mutex_, priority_dispatch_, pool, *this,
-        block_pool_, settings, bitcoin_settings),
+        block_pool_, script_cache_, metrics_cache_, settings,
+        bitcoin_settings),
     organize_transaction_(confirmation_mutex_, priority_dispatch_, pool, *this,
-        transaction_pool_, settings),
+        transaction_pool_, script_cache_, metrics_cache_, settings),
 
     // Subscriber thread pools are only used for unsubscribe, otherwise invoke.
     block_subscriber_(std::make_shared<block_subscriber>(pool, NAME "_block")),
@@ -327,6 +384,13 @@ bool block_chain::get_neutrino_filter_header(
 bool block_chain::get_block_hash(hash_digest& out_hash, size_t height,
     bool candidate) const
 {
+    const auto& index = candidate ? candidate_index_ : confirmed_index_;
+    const auto& window = candidate ? candidate_window_ : confirmed_window_;
+
+    if (index.get_block_hash(out_hash, height) ||
+        window.get_block_hash(out_hash, height))
+        return true;
+
     const auto result = database_.blocks().get(height, candidate);
 
     if (!result)
@@ -351,6 +415,13 @@ bool block_chain::get_block_error(code& out_error,
 bool block_chain::get_bits(uint32_t& out_bits, size_t height,
     bool candidate) const
 {
+    const auto& index = candidate ? candidate_index_ : confirmed_index_;
+    const auto& window = candidate ? candidate_window_ : confirmed_window_;
+
+    if (index.get_bits(out_bits, height) ||
+        window.get_bits(out_bits, height))
+        return true;
+
     auto result = database_.blocks().get(height, candidate);
 
     if (!result)
@@ -363,6 +434,13 @@ bool block_chain::get_bits(uint32_t& out_bits, size_t height,
 bool block_chain::get_timestamp(uint32_t& out_timestamp, size_t height,
     bool candidate) const
 {
+    const auto& index = candidate ? candidate_index_ : confirmed_index_;
+    const auto& window = candidate ? candidate_window_ : confirmed_window_;
+
+    if (index.get_timestamp(out_timestamp, height) ||
+        window.get_timestamp(out_timestamp, height))
+        return true;
+
     auto result = database_.blocks().get(height, candidate);
 
     if (!result)
@@ -375,6 +453,13 @@ bool block_chain::get_timestamp(uint32_t& out_timestamp, size_t height,
 bool block_chain::get_version(uint32_t& out_version, size_t height,
     bool candidate) const
 {
+    const auto& index = candidate ? candidate_index_ : confirmed_index_;
+    const auto& window = candidate ? candidate_window_ : confirmed_window_;
+
+    if (index.get_version(out_version, height) ||
+        window.get_version(out_version, height))
+        return true;
+
     auto result = database_.blocks().get(height, candidate);
 
     if (!result)
@@ -394,6 +479,11 @@ bool block_chain::get_work(uint256_t& out_work, const uint256_t& overcome,
     if (!database_.blocks().top(top, candidate))
         return false;
 
+    const auto& index = candidate ? candidate_index_ : confirmed_index_;
+
+    if (index.get_work(out_work, overcome, above_height, top))
+        return true;
+
     const auto no_maximum = overcome.is_zero();
 
     for (auto height = top; (height > above_height) &&
@@ -446,6 +536,8 @@ void block_chain::populate_header(const chain::header& header) const
     database_.blocks().get_header_metadata(header);
 }
 
+// Block txs are added to the filter by update before population, so the
+// filter cannot short-circuit this lookup.
 void block_chain::populate_block_transaction(const chain::transaction& tx,
     uint32_t forks, size_t fork_height) const
 {
@@ -455,14 +547,16 @@ void block_chain::populate_block_transaction(const chain::transaction& tx,
 void block_chain::populate_pool_transaction(const chain::transaction& tx,
     uint32_t forks) const
 {
+    // Metadata is left as not found, as would be set by a store miss.
+    if (!transaction_filter_.contains(tx.hash()))
+        return;
+
     database_.transactions().get_pool_metadata(tx, forks);
 }
 
 code block_chain::populate_neutrino_filters(
     block_const_ptr_list_const_ptr blocks) const
 {
-    static const auto form = "Block [%s] halts neutrino filter calculation due to missing metadata";
-
     if (!settings_.bip158)
         return error::success;
 
@@ -494,8 +588,45 @@ code block_chain::populate_neutrino_filters(
         }
     }
 
-    for (const auto& block: *blocks)
+    const auto count = blocks->size();
+
+    if (count == 0u)
+        return error::success;
+
+    // Filters are independent, only filter headers are chained.
+    const auto filters = std::make_shared<data_stack>(count);
+    std::promise<code> computed;
+    const result_handler complete = [&computed](const code& ec)
     {
+        computed.set_value(ec);
+    };
+
+    // One thread is reserved, as the calling thread blocks on the join.
+    const auto threads = floor_subtract(priority_dispatch_.size(), size_t{1});
+    const auto buckets = std::min(threads, count);
+
+    if (buckets == 0u)
+    {
+        compute_neutrino_filters(blocks, filters, 0, 1, complete);
+    }
+    else
+    {
+        const auto join_handler = synchronize(complete, buckets,
+            NAME "_filters");
+
+        for (size_t bucket = 0; bucket < buckets; ++bucket)
+            priority_dispatch_.concurrent(
+                &block_chain::compute_neutrino_filters, this, blocks,
+                    filters, bucket, buckets, join_handler);
+    }
+
+    code ec;
+    if ((ec = computed.get_future().get()))
+        return ec;
+
+    for (size_t index = 0; index < count; ++index)
+    {
+        const auto& block = (*blocks)[index];
         const auto& header = block->header();
         if (header.metadata.neutrino_filter)
         {
@@ -503,20 +634,13 @@ code block_chain::populate_neutrino_filters(
             continue;
         }
 
-        data_chunk filter;
-        if (!system::neutrino::compute_filter(*block, filter))
-        {
-            LOG_ERROR(LOG_BLOCKCHAIN)
-                << boost::format(form) % encode_hash(block->hash());
-
-            return error::metadata_prevout_missing;
-        }
-
+        auto& filter = (*filters)[index];
         const auto filter_header = system::neutrino::compute_filter_header(
             previous_filter_header, filter);
 
         header.metadata.neutrino_filter = std::make_shared<chain::block_filter>(
-            neutrino_filter_type, block->hash(), filter_header, filter);
+            neutrino_filter_type, block->hash(), filter_header,
+                std::move(filter));
 
         previous_filter_header = filter_header;
     }
@@ -524,15 +648,52 @@ code block_chain::populate_neutrino_filters(
     return error::success;
 }
 
+void block_chain::compute_neutrino_filters(
+    block_const_ptr_list_const_ptr blocks, std::shared_ptr<data_stack> filters,
+    size_t bucket, size_t buckets, result_handler handler) const
+{
+    static const auto form = "Block [%s] halts neutrino filter calculation due to missing metadata";
+
+    for (auto index = bucket; index < blocks->size();
+        index = ceiling_add(index, buckets))
+    {
+        const auto& block = (*blocks)[index];
+
+        if (block->header().metadata.neutrino_filter)
+            continue;
+
+        if (!system::neutrino::compute_filter(*block, (*filters)[index]))
+        {
+            LOG_ERROR(LOG_BLOCKCHAIN)
+                << boost::format(form) % encode_hash(block->hash());
+
+            handler(error::metadata_prevout_missing);
+            return;
+        }
+    }
+
+    handler(error::success);
+}
+
 bool block_chain::populate_block_output(const chain::output_point& outpoint,
     size_t fork_height) const
 {
-    return database_.transactions().get_output(outpoint, fork_height);
+    if (utxo_cache_.populate(outpoint, fork_height))
+        return true;
+
+    // Read sequence before the store so a concurrent spend is not cached.
+    const auto sequence = utxo_cache_.sequence();
+
+    if (!database_.transactions().get_output(outpoint, fork_height))
+        return false;
+
+    utxo_cache_.add(outpoint, fork_height, sequence);
+    return true;
 }
 
 bool block_chain::populate_pool_output(const chain::output_point& outpoint) const
 {
-    return database_.transactions().get_output(outpoint, max_size_t);
+    return populate_block_output(outpoint, max_size_t);
 }
 
 uint8_t block_chain::get_block_state(size_t height, bool candidate) const
@@ -613,6 +774,9 @@ code block_chain::store(transaction_const_ptr tx)
     // Clear chain state for store, index_transaction and notify.
     tx->metadata.state.reset();
 
+    // Add before store so that a concurrent population cannot miss it.
+    transaction_filter_.add(tx->hash());
+
     code ec;
     if ((ec = database_.store(*tx, state->enabled_forks())))
         return ec;
@@ -649,10 +813,17 @@ code block_chain::reorganize(const config::checkpoint& fork,
     const auto fork_height = fork.height();
     const auto outgoing = std::make_shared<header_const_ptr_list>();
 
+    // Pop first so that memory never holds a header no longer indexed.
+    pop_headers(fork_height, true);
+
     // This unmarks candidate txs and spent outputs (may have been validated).
     if ((ec = database_.reorganize(fork, incoming, outgoing)))
         return ec;
 
+    auto height = fork_height;
+    for (const auto& header: *incoming)
+        push_header(*header, ++height, true);
+
     // Don't add outgoing because only populated after reorganize and at that
     // point the headers are no longer indexed (populator requires indexation).
     header_pool_.remove(incoming);
@@ -682,6 +853,10 @@ code block_chain::update(block_const_ptr block, size_t height)
 
     if (!metadata.error)
     {
+        // Add before store so that a concurrent population cannot miss it.
+        for (const auto& tx: block->transactions())
+            transaction_filter_.add(tx.hash());
+
         // Store or connect each transaction and set tx link metadata.
         return database_.update(*block, height);
     }
@@ -733,6 +908,9 @@ code block_chain::invalidate(block_const_ptr block, size_t block_height)
         if ((ec = invalidate(*header, error::store_block_missing_parent)))
             return ec;
 
+    // Pop first so that memory never holds a header no longer indexed.
+    pop_headers(fork_height, true);
+
     // This should not have to unmark because none were ever valid.
     if ((ec = database_.reorganize(fork, incoming, outgoing)))
         return ec;
@@ -755,6 +933,9 @@ code block_chain::candidate(block_const_ptr block)
     if ((ec = database_.candidate(*block)))
         return ec;
 
+    // Outputs spent by a candidate are no longer unspent in both chains.
+    utxo_cache_.remove_spent(*block);
+
     // Advance the top valid candidate state and candidate work.
     set_top_valid_candidate_state(header.metadata.state);
     set_candidate_work(candidate_work() + header.proof());
@@ -809,15 +990,47 @@ code block_chain::reorganize(block_const_ptr_list_const_ptr branch_cache,
         incoming->push_back(block);
     }
 
-    // Conditionally compute neutrino filters for all incoming blocks
+    // Conditionally compute neutrino filters for all incoming blocks.
+    // Payments are cataloged by the store within its reorganize write, which
+    // is not exposed here, so that work is not parallelized by this batch.
     if ((ec = populate_neutrino_filters(incoming)))
         return ec;
 
+    // Pop first so that memory never holds a header no longer indexed.
+    pop_headers(fork.height(), false);
+
     // This unmarks candidate txs and spent outputs (because confirmed).
     // Header metadata median_time_past must be set on all incoming blocks.
     if ((ec = database_.reorganize(fork, incoming, outgoing)))
         return ec;
 
+    auto height = fork.height();
+    for (const auto& block: *incoming)
+        push_header(block->header(), ++height, false);
+
+    // Outputs of outgoing blocks are no longer confirmed, and their spends
+    // are restored only in the store (spent outputs are not cached).
+    for (const auto& block: *outgoing)
+        utxo_cache_.remove_created(*block);
+
+    height = fork.height();
+    for (const auto& block: *incoming)
+    {
+        utxo_cache_.remove_spent(*block);
+        utxo_cache_.add(*block, ++height);
+    }
+
+    LOG_DEBUG(LOG_BLOCKCHAIN)
+        << "Utxo cache outputs (" << utxo_cache_.size() << ") bytes ("
+        << utxo_cache_.bytes() << ") hits (" << utxo_cache_.hits()
+        << ") misses (" << utxo_cache_.misses() << ").";
+
+    LOG_DEBUG(LOG_BLOCKCHAIN)
+        << "Transaction filter hashes (" << transaction_filter_.size()
+        << ") queries (" << transaction_filter_.queries() << ") negatives ("
+        << transaction_filter_.negatives() << ") false positive rate ("
+        << transaction_filter_.false_positive_rate() << ").";
+
     // Top valid candidate is now top confirmed and the new fork point.
     set_fork_point({ top->hash(), top_state->height() });
     set_candidate_work(0);
@@ -880,22 +1093,390 @@ bool block_chain::set_fork_point()
 
     hash_digest candidate_hash;
     hash_digest confirmed_hash;
-    auto common = std::min(candidate_height, confirmed_height);
+    size_t common = 0;
+    auto maximum = std::min(candidate_height, confirmed_height);
 
-    // The loop must at least terminate on the genesis block.
+    // The search must at least terminate on the genesis block.
     BITCOIN_ASSERT(get_block_hash(candidate_hash, 0, true));
     BITCOIN_ASSERT(get_block_hash(confirmed_hash, 0, false));
     BITCOIN_ASSERT(candidate_hash == confirmed_hash);
 
-    while (get_block_hash(candidate_hash, common, true) &&
-        get_block_hash(confirmed_hash, common, false) &&
-        candidate_hash != confirmed_hash)
-        --common;
+    // A hash commits to all of its ancestors, so the indexes match at and
+    // below the fork point and differ above it. Find it by binary search.
+    while (common < maximum)
+    {
+        const auto middle = common + (maximum - common + 1u) / 2u;
+
+        if (!get_block_hash(candidate_hash, middle, true) ||
+            !get_block_hash(confirmed_hash, middle, false))
+            return false;
+
+        if (candidate_hash == confirmed_hash)
+            common = middle;
+        else
+            maximum = middle - 1u;
+    }
+
+    if (!get_block_hash(confirmed_hash, common, false))
+        return false;
 
     set_fork_point({ confirmed_hash, common });
     return true;
 }
 
+// private.
+bool block_chain::set_header_index(bool candidate)
+{
+    if (!settings_.index_headers)
+        return true;
+
+    size_t top;
+    if (!get_top_height(top, candidate))
+        return false;
+
+    auto& index = candidate ? candidate_index_ : confirmed_index_;
+    index.pop(0);
+    index.reserve(top + 1u);
+
+    // Read from the store, as the index is not yet complete.
+    for (size_t height = index.size(); height <= top; ++height)
+    {
+        const auto result = database_.blocks().get(height, candidate);
+
+        if (!result)
+            return false;
+
+        index.push(result.header(), height);
+    }
+
+    return true;
+}
+
+// private.
+bool block_chain::set_header_window(bool candidate)
+{
+    size_t top;
+    if (!get_top_height(top, candidate))
+        return false;
+
+    auto& window = candidate ? candidate_window_ : confirmed_window_;
+    const auto count = std::min(top + 1u, window.capacity());
+
+    chain::header header;
+    for (auto height = top + 1u - count; height <= top; ++height)
+    {
+        if (!get_header(header, height, candidate))
+            return false;
+
+        window.push(header, height);
+    }
+
+    return true;
+}
+
+// protected
+// Writes markers, work, header windows and (if configured) header indexes,
+// followed by a sha256 checksum.
+bool block_chain::save_snapshot() const
+{
+    config::checkpoint candidate_top;
+    config::checkpoint confirmed_top;
+    const auto top_valid = top_valid_candidate_state();
+
+    if (!top_valid || !get_top(candidate_top, true) ||
+        !get_top(confirmed_top, false))
+        return false;
+
+    data_chunk data;
+    data_sink ostream(data);
+    ostream_writer sink(ostream);
+    sink.write_4_bytes_little_endian(snapshot_version);
+    write_checkpoint(sink, candidate_top);
+    write_checkpoint(sink, confirmed_top);
+    write_checkpoint(sink, fork_point());
+    sink.write_8_bytes_little_endian(top_valid->height());
+    write_work(sink, candidate_work());
+    write_work(sink, confirmed_work());
+    candidate_window_.to_data(sink);
+    confirmed_window_.to_data(sink);
+    sink.write_byte(settings_.index_headers ? 1 : 0);
+
+    if (settings_.index_headers)
+    {
+        candidate_index_.to_data(sink);
+        confirmed_index_.to_data(sink);
+    }
+
+    ostream.flush();
+    extend_data(data, sha256_hash(data));
+
+    // Replace the prior snapshot only once the new one is complete.
+    const auto temporary = snapshot_path_.string() + ".tmp";
+    bc::system::ofstream file(temporary, std::ofstream::binary);
+    file.write(reinterpret_cast<const char*>(data.data()), data.size());
+    file.close();
+
+    if (!file)
+        return false;
+
+    boost::system::error_code ec;
+    boost::filesystem::rename(temporary, snapshot_path_, ec);
+    return !ec;
+}
+
+// protected
+// The snapshot is used only if it matches the store tops, fork point and top
+// valid candidate. As a hash commits to all ancestors, matching tops imply
+// matching header windows, header indexes and work. A snapshot without header
+// indexes is not used when indexes are configured. Otherwise state is
+// recomputed.
+bool block_chain::load_snapshot()
+{
+    bc::system::ifstream file(snapshot_path_.string(), std::ifstream::binary);
+
+    if (!file)
+        return false;
+
+    data_chunk data{ std::istreambuf_iterator<char>(file),
+        std::istreambuf_iterator<char>() };
+
+    if (data.size() < hash_size)
+        return false;
+
+    const auto payload_size = data.size() - hash_size;
+    const data_chunk payload(data.begin(), data.begin() + payload_size);
+    const auto checksum = sha256_hash(payload);
+
+    if (!std::equal(checksum.begin(), checksum.end(),
+        data.begin() + payload_size))
+        return false;
+
+    data_source istream(payload);
+    istream_reader source(istream);
+
+    if (source.read_4_bytes_little_endian() != snapshot_version)
+        return false;
+
+    const auto saved_candidate_top = read_checkpoint(source);
+    const auto saved_confirmed_top = read_checkpoint(source);
+    const auto fork = read_checkpoint(source);
+    const auto top_valid = source.read_8_bytes_little_endian();
+    const auto work_above_candidate_fork = read_work(source);
+    const auto work_above_confirmed_fork = read_work(source);
+
+    config::checkpoint candidate_top;
+    config::checkpoint confirmed_top;
+    hash_digest candidate_hash;
+    hash_digest confirmed_hash;
+
+    if (!source ||
+        !get_top(candidate_top, true) ||
+        !get_top(confirmed_top, false) ||
+        candidate_top != saved_candidate_top ||
+        confirmed_top != saved_confirmed_top)
+        return false;
+
+    // Validity may change without a change of tops, so check the top valid
+    // candidate is valid and its successor (if any) is not.
+    if (!get_block_hash(candidate_hash, fork.height(), true) ||
+        !get_block_hash(confirmed_hash, fork.height(), false) ||
+        candidate_hash != fork.hash() || confirmed_hash != fork.hash() ||
+        top_valid > candidate_top.height() ||
+        !is_valid(get_block_state(top_valid, true)) ||
+        (top_valid < candidate_top.height() &&
+            is_valid(get_block_state(top_valid + 1u, true))))
+        return false;
+
+    if (!candidate_window_.from_data(source) ||
+        !confirmed_window_.from_data(source))
+        return false;
+
+    const auto indexed = source.read_byte() != 0;
+
+    if (!source || indexed != settings_.index_headers)
+        return false;
+
+    hash_digest candidate_top_hash;
+    hash_digest confirmed_top_hash;
+
+    // The indexes must extend exactly to the store tops.
+    if (indexed && (!candidate_index_.from_data(source) ||
+        !confirmed_index_.from_data(source) ||
+        !candidate_index_.get_block_hash(candidate_top_hash,
+            candidate_top.height()) ||
+        !confirmed_index_.get_block_hash(confirmed_top_hash,
+            confirmed_top.height()) ||
+        candidate_index_.size() != candidate_top.height() + 1u ||
+        confirmed_index_.size() != confirmed_top.height() + 1u ||
+        candidate_top_hash != candidate_top.hash() ||
+        confirmed_top_hash != confirmed_top.hash()))
+        return false;
+
+    const auto state = chain_state_populator_.populate(top_valid, true);
+
+    if (!state)
+        return false;
+
+    set_fork_point(fork);
+    set_top_valid_candidate_state(state);
+    set_candidate_work(work_above_candidate_fork);
+    set_confirmed_work(work_above_confirmed_fork);
+
+    LOG_INFO(LOG_BLOCKCHAIN)
+        << "Loaded chain state snapshot at candidate ("
+        << candidate_top.height() << ") confirmed ("
+        << confirmed_top.height() << ").";
+
+    return true;
+}
+
+// private.
+// Writes the store tops and the filter, followed by a sha256 checksum.
+// Only a complete (unsaturated) filter is written.
+bool block_chain::save_transaction_filter() const
+{
+    config::checkpoint candidate_top;
+    config::checkpoint confirmed_top;
+
+    if (transaction_filter_.saturated() || !get_top(candidate_top, true) ||
+        !get_top(confirmed_top, false))
+        return true;
+
+    data_chunk data;
+    data_sink ostream(data);
+    ostream_writer sink(ostream);
+    sink.write_4_bytes_little_endian(transaction_filter_version);
+    write_checkpoint(sink, candidate_top);
+    write_checkpoint(sink, confirmed_top);
+    transaction_filter_.to_data(sink);
+    ostream.flush();
+    extend_data(data, sha256_hash(data));
+
+    // Replace the prior filter only once the new one is complete.
+    const auto temporary = transaction_filter_path_.string() + ".tmp";
+    bc::system::ofstream file(temporary, std::ofstream::binary);
+    file.write(reinterpret_cast<const char*>(data.data()), data.size());
+    file.close();
+
+    if (!file)
+        return false;
+
+    boost::system::error_code ec;
+    boost::filesystem::rename(temporary, transaction_filter_path_, ec);
+    return !ec;
+}
+
+// private.
+// The filter is used only if it matches the store tops. It is removed once
+// read, as transactions stored before the next clean close would be missing
+// from it following a hard shutdown.
+bool block_chain::load_transaction_filter()
+{
+    bc::system::ifstream file(transaction_filter_path_.string(),
+        std::ifstream::binary);
+
+    if (!file)
+        return false;
+
+    data_chunk data{ std::istreambuf_iterator<char>(file),
+        std::istreambuf_iterator<char>() };
+
+    file.close();
+    boost::system::error_code ec;
+    boost::filesystem::remove(transaction_filter_path_, ec);
+
+    if (ec || data.size() < hash_size)
+        return false;
+
+    const auto payload_size = data.size() - hash_size;
+    const data_chunk payload(data.begin(), data.begin() + payload_size);
+    const auto checksum = sha256_hash(payload);
+
+    if (!std::equal(checksum.begin(), checksum.end(),
+        data.begin() + payload_size))
+        return false;
+
+    data_source istream(payload);
+    istream_reader source(istream);
+
+    if (source.read_4_bytes_little_endian() != transaction_filter_version)
+        return false;
+
+    const auto saved_candidate_top = read_checkpoint(source);
+    const auto saved_confirmed_top = read_checkpoint(source);
+
+    config::checkpoint candidate_top;
+    config::checkpoint confirmed_top;
+
+    if (!source ||
+        !get_top(candidate_top, true) ||
+        !get_top(confirmed_top, false) ||
+        candidate_top != saved_candidate_top ||
+        confirmed_top != saved_confirmed_top ||
+        !transaction_filter_.from_data(source))
+        return false;
+
+    LOG_INFO(LOG_BLOCKCHAIN)
+        << "Loaded transaction filter hashes (" << transaction_filter_.size()
+        << ") false positive rate ("
+        << transaction_filter_.false_positive_rate() << ").";
+
+    return true;
+}
+
+// private.
+// A filter persisted at a clean close is complete, so negatives are definite.
+// A rebuild from confirmed and candidate blocks omits transactions stored in a
+// prior session in neither chain (pool and orphaned block transactions), and
+// requires reading all blocks, so it is opt-in. Otherwise the filter is
+// advisory (always positive) for the session.
+bool block_chain::set_transaction_filter()
+{
+    BITCOIN_ASSERT_MSG(fork_point().hash() != null_hash, "Set fork point.");
+
+    // Disabled.
+    if (transaction_filter_.saturated())
+        return true;
+
+    if (load_transaction_filter())
+        return true;
+
+    if (!settings_.transaction_filter_rebuild)
+    {
+        transaction_filter_.saturate();
+        return true;
+    }
+
+    size_t candidate_height;
+    size_t confirmed_height;
+
+    if (!get_top_height(candidate_height, true) ||
+        !get_top_height(confirmed_height, false))
+        return false;
+
+    transaction_filter_.clear();
+
+    // Stop reading once saturated, as the filter is then always positive.
+    for (size_t height = 0; height <= confirmed_height &&
+        !transaction_filter_.saturated(); ++height)
+        if (!add_transaction_hashes(height, false))
+            return false;
+
+    for (auto height = fork_point().height() + 1; height <= candidate_height &&
+        !transaction_filter_.saturated(); ++height)
+        if (!add_transaction_hashes(height, true))
+            return false;
+
+    LOG_INFO(LOG_BLOCKCHAIN)
+        << "Transaction filter hashes (" << transaction_filter_.size()
+        << ") bytes (" << transaction_filter_.bytes()
+        << ") saturated (" << transaction_filter_.saturated()
+        << ") false positive rate ("
+        << transaction_filter_.false_positive_rate() << ").";
+
+    return true;
+}
+
 // private.
 bool block_chain::set_candidate_work()
 {
@@ -932,16 +1513,26 @@ bool block_chain::set_top_candidate_state()
 // private.
 bool block_chain::set_top_valid_candidate_state()
 {
-    size_t height;
-    if (!get_top_height(height, true))
+    size_t top;
+    if (!get_top_height(top, true))
         return false;
 
-    // The loop must at least terminate on the genesis block.
+    // The search must at least terminate on the genesis block.
     BITCOIN_ASSERT(is_valid(get_block_state(0, true)));
 
-    // Loop from top to genesis in the candidate index.
-    while (!is_valid(get_block_state(height, true)))
-        --height;
+    // A block is validated only if its parent is valid, and validity is never
+    // cleared, so candidates are valid up to the top valid and not above it.
+    // Find it by binary search over the candidate index.
+    size_t height = 0;
+    while (height < top)
+    {
+        const auto middle = height + (top - height + 1u) / 2u;
+
+        if (is_valid(get_block_state(middle, true)))
+            height = middle;
+        else
+            top = middle - 1u;
+    }
 
     const auto state = chain_state_populator_.populate(height, true);
     set_top_valid_candidate_state(state);
@@ -1070,12 +1661,23 @@ bool block_chain::start()
     header_subscriber_->start();
     transaction_subscriber_->start();
 
-    return set_fork_point()
+    // A matching snapshot replaces index scans, header index and window
+    // reads, and work sums.
+    const auto loaded = load_snapshot();
+
+    initialized_ = (loaded || set_fork_point())
+        && (loaded || set_header_index(true))
+        && (loaded || set_header_index(false))
+        && (loaded || set_header_window(true))
+        && (loaded || set_header_window(false))
+        && set_transaction_filter()
         && set_top_candidate_state()
-        && set_top_valid_candidate_state()
+        && (loaded || set_top_valid_candidate_state())
         && set_next_confirmed_state()
-        && set_candidate_work()
-        && set_confirmed_work()
+        && (loaded || set_candidate_work())
+        && (loaded || set_confirmed_work());
+
+    return initialized_
         && organize_block_.start()
         && organize_header_.start()
         && organize_transaction_.start();
@@ -1116,8 +1718,25 @@ bool block_chain::stop()
 // Optional as the blockchain will close on destruct.
 bool block_chain::close()
 {
+    // Snapshot only if started with fully initialized state.
+    const auto initialized = !stopped() && initialized_;
     const auto result = stop();
     priority_pool_.join();
+
+    // Work is coalesced, so the snapshot is consistent with the store.
+    if (initialized && !save_snapshot())
+    {
+        LOG_WARNING(LOG_BLOCKCHAIN)
+            << "Failed to write chain state snapshot.";
+    }
+
+    // Stores are coalesced, so the filter is complete for the store.
+    if (initialized && !save_transaction_filter())
+    {
+        LOG_WARNING(LOG_BLOCKCHAIN)
+            << "Failed to write transaction filter.";
+    }
+
     return result && database_.close();
 }
 
@@ -1149,6 +1768,46 @@ bool block_chain::get_transactions(transaction::list& out_transactions,
     return true;
 }
 
+// private
+void block_chain::pop_headers(size_t fork_height, bool candidate)
+{
+    auto& index = candidate ? candidate_index_ : confirmed_index_;
+    auto& window = candidate ? candidate_window_ : confirmed_window_;
+
+    if (settings_.index_headers)
+        index.pop(fork_height);
+
+    window.pop(fork_height);
+}
+
+// private
+void block_chain::push_header(const chain::header& header, size_t height,
+    bool candidate)
+{
+    auto& index = candidate ? candidate_index_ : confirmed_index_;
+    auto& window = candidate ? candidate_window_ : confirmed_window_;
+
+    if (settings_.index_headers)
+        index.push(header, height);
+
+    window.push(header, height);
+}
+
+// private
+bool block_chain::add_transaction_hashes(size_t height, bool candidate)
+{
+    hash_list hashes;
+    const auto result = database_.blocks().get(height, candidate);
+
+    if (!result || !get_transaction_hashes(hashes, result))
+        return false;
+
+    for (const auto& hash: hashes)
+        transaction_filter_.add(hash);
+
+    return true;
+}
+
 // private
 bool block_chain::get_transaction_hashes(hash_list& out_hashes,
     const database::block_result& result) const
@@ -2101,16 +2760,16 @@ void block_chain::fetch_header_locator(const block::indexes& heights,
 
     for (const auto height: heights)
     {
-        // Header locators is generated for the header chain.
-        const auto result = database_.blocks().get(height, true);
+        hash_digest hash;
 
-        if (!result)
+        // Header locators is generated for the header chain.
+        if (!get_block_hash(hash, height, true))
         {
             handler(error::not_found, nullptr);
-            break;
+            return;
         }
 
-        hashes.push_back(result.hash());
+        hashes.push_back(hash);
     }
 
     handler(error::success, message);
@@ -2348,6 +3007,12 @@ void block_chain::organize(header_const_ptr header, result_handler handler)
     organize_header_.organize(header, handler);
 }
 
+void block_chain::organize(headers_const_ptr headers, result_handler handler)
+{
+    // The handler must not call organize (lock safety).
+    organize_header_.organize(headers, handler);
+}
+
 void block_chain::organize(transaction_const_ptr tx, result_handler handler)
 {
     // The handler must not call organize (lock safety).
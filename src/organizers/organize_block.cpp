@@ -18,6 +18,7 @@
  */
 #include <bitcoin/blockchain/organizers/organize_block.hpp>
 
+#include <algorithm>
 #include <chrono>
 #include <cstddef>
 #include <functional>
@@ -39,17 +40,33 @@ using namespace std::placeholders;
 
 #define NAME "organize_block"
 
+// The maximum number of checkpoint-covered blocks reorganized at one time.
+static constexpr size_t reorganize_batch = 100;
+
+// The block pool only fetches within block_buffer_limit of the fork point,
+// so a deferred batch may not extend beyond it.
+static size_t batch_limit(size_t block_buffer_limit)
+{
+    return block_buffer_limit == 0 ? reorganize_batch :
+        std::min(reorganize_batch, block_buffer_limit);
+}
+
 organize_block::organize_block(prioritized_mutex& mutex,
     dispatcher& priority_dispatch, threadpool& threads, fast_chain& chain,
-    block_pool& pool, const settings& settings,
-    const system::settings& bitcoin_settings)
+    block_pool& pool, const script_cache& cache, const metrics_cache& metrics,
+    const settings& settings, const system::settings& bitcoin_settings)
   : fast_chain_(chain),
     mutex_(mutex),
     stopped_(true),
     pool_(pool),
     dispatch_(priority_dispatch),
-    validator_(priority_dispatch, chain, settings, bitcoin_settings),
-    downloader_subscriber_(std::make_shared<download_subscriber>(threads, NAME))
+    validator_(priority_dispatch, chain, cache, metrics, settings,
+        bitcoin_settings),
+    downloader_subscriber_(
+        std::make_shared<download_subscriber>(threads, NAME)),
+    pipeline_(settings.pipeline_validation),
+    reorganize_batch_(batch_limit(settings.block_buffer_limit)),
+    checkpoints_(settings.checkpoints)
 {
 }
 
@@ -131,7 +148,7 @@ void organize_block::prime_validation(size_t height) const
 // Therefore fan-outs may use all threads in the priority threadpool.
 
 // This is the start of the validation sequence.
-// TODO: can confirm in parallel if not validating or indexing, and no gaps.
+// Checkpoint-covered blocks are reorganized in batches (see defer).
 bool organize_block::handle_check(const code& ec, size_t height)
 {
     BITCOIN_ASSERT(!ec || ec == error::service_stopped);
@@ -173,6 +190,9 @@ bool organize_block::handle_check(const code& ec, size_t height)
 // private
 void organize_block::handle_complete(const code& ec)
 {
+    // Discard any block accepted ahead of a sequence that did not reach it.
+    rollback();
+
     mutex_.unlock_high_priority();
     ///////////////////////////////////////////////////////////////////////////
 
@@ -221,7 +241,7 @@ void organize_block::handle_fetch(const code& ec, block_const_ptr block,
     // Checks that are dependent upon chain state.
     // Populate, accept, and connect durations set here.
     // Deserialization duration and median_time_past set by read.
-    if ((error_code = validate(block)))
+    if ((error_code = validate(block, height)))
     {
         complete(error_code);
         return;
@@ -259,7 +279,7 @@ void organize_block::handle_fetch(const code& ec, block_const_ptr block,
     // Add the valid candidate to the candidate sub-branch.
     sub_branch->push_back(block);
 
-    if (fast_chain_.is_reorganizable())
+    if (fast_chain_.is_reorganizable() && !defer(height, sub_branch->size()))
     {
         const auto branch_height = height - (sub_branch->size() - 1u);
 
@@ -284,11 +304,43 @@ void organize_block::handle_fetch(const code& ec, block_const_ptr block,
         ++height, block->hash(), sub_branch, complete);
 }
 
+// protected
+// Covered blocks require no contextual validation, so confirmation of a
+// contiguous covered range is deferred into batches. Each reorganization then
+// computes its filters concurrently and writes the batch in one store call.
+// Blocks deferred at a download gap are confirmed with the next reorganize.
+bool organize_block::defer(size_t height, size_t branch_size) const
+{
+    return branch_size < reorganize_batch_ &&
+        config::checkpoint::covered(height + 1u, checkpoints_);
+}
+
+// private
+bool organize_block::is_candidate(block_const_ptr block, size_t height) const
+{
+    hash_digest candidate_hash;
+    return fast_chain_.get_block_hash(candidate_hash, height, true) &&
+        candidate_hash == block->hash();
+}
+
 // private
 void organize_block::block_fetcher(size_t height,
     const hash_digest& parent_hash, block_const_ptr_list_ptr sub_branch,
     result_handler complete)
 {
+    // The block may have been fetched and accepted ahead by the pipeline.
+    // A header reorganization may have since replaced it as the candidate.
+    if (next_ && next_->block->header().previous_block_hash() == parent_hash &&
+        is_candidate(next_->block, height))
+    {
+        handle_fetch(error::success, next_->block, height, parent_hash,
+            sub_branch, complete);
+        return;
+    }
+
+    // Return any block accepted ahead to the pool before fetching.
+    rollback();
+
     pool_.fetch(height,
         std::bind(&organize_block::handle_fetch,
             this, _1, _2, height, parent_hash, sub_branch, complete));
@@ -299,8 +351,56 @@ void organize_block::block_fetcher(size_t height,
 
 // private
 // Convert validate.accept/connect to a sequential call.
-code organize_block::validate(block_const_ptr block)
+code organize_block::validate(block_const_ptr block, size_t height)
+{
+    code ec;
+
+    if ((ec = accept(block)))
+        return ec;
+
+    // Accept the next candidate concurrently with the connect of this one.
+    if (pipeline_ && !block->header().metadata.error)
+        speculate(block, height + 1u);
+
+    ec = connect(block);
+
+    // Commits are ordered, so the next acceptance must complete first.
+    settle();
+    return ec;
+}
+
+// protected
+code organize_block::accept(block_const_ptr block)
 {
+    const auto accepted = next_ && next_->block == block;
+
+    // A block accepted ahead but not reached is returned to the pool.
+    if (!accepted)
+        rollback();
+
+    const auto next = next_;
+    next_.reset();
+
+    // A confirmed reorganization moves the fork point, which may change the
+    // confirmed state of any prevout, so population is then repeated fully.
+    const auto fork_hash = fast_chain_.fork_point().hash();
+    const auto forked = accepted && fork_hash != next->fork_point.hash();
+
+    if (accepted)
+    {
+        // Acceptance stands unless metadata was refreshed from the parent.
+        if (!forked && !validator_.repopulate(block, next->parent))
+            return error::success;
+
+        // Restore check results, as acceptance may have overwritten them.
+        auto& metadata = block->header().metadata;
+        metadata.error = next->error;
+        metadata.validated = next->validated;
+
+        if (forked)
+            metadata.state = next->state;
+    }
+
     resume_ = {};
 
     const result_handler complete =
@@ -309,10 +409,33 @@ code organize_block::validate(block_const_ptr block)
 
     const auto accept_handler =
         std::bind(&organize_block::handle_accept,
-            this, _1, block, complete);
+            this, _1, complete);
 
     // Checks that are dependent upon chain state.
-    validator_.accept(block, accept_handler);
+    if (accepted && !forked)
+        validator_.accept_populated(block, accept_handler);
+    else
+        validator_.accept(block, accept_handler);
+
+    // Store failed or received stop code from validator.
+    return resume_.get_future().get();
+}
+
+// private
+code organize_block::connect(block_const_ptr block)
+{
+    resume_ = {};
+
+    const result_handler complete =
+        std::bind(&organize_block::signal_completion,
+            this, _1);
+
+    const auto connect_handler =
+        std::bind(&organize_block::handle_connect,
+            this, _1, block, complete);
+
+    // Checks that include script metadata.
+    validator_.connect(block, connect_handler);
 
     // Store failed or received stop code from validator.
     return resume_.get_future().get();
@@ -325,8 +448,7 @@ void organize_block::signal_completion(const code& ec)
 }
 
 // private
-void organize_block::handle_accept(const code& ec, block_const_ptr block,
-    result_handler handler)
+void organize_block::handle_accept(const code& ec, result_handler handler)
 {
     if (stopped())
     {
@@ -334,18 +456,7 @@ void organize_block::handle_accept(const code& ec, block_const_ptr block,
         return;
     }
 
-    if (ec)
-    {
-        handler(ec);
-        return;
-    }
-
-    const auto connect_handler =
-        std::bind(&organize_block::handle_connect,
-            this, _1, block, handler);
-
-    // Checks that include script metadata.
-    validator_.connect(block, connect_handler);
+    handler(ec);
 }
 
 // private
@@ -367,5 +478,89 @@ void organize_block::handle_connect(const code& ec, block_const_ptr,
     handler(error::success);
 }
 
+// Pipeline sub-sequence.
+//-----------------------------------------------------------------------------
+// The next block is populated and accepted against the state of its parent
+// while the parent's inputs are connected. Nothing is written to the store
+// until the parent is committed, after which metadata that depends on the
+// parent is refreshed and the next block is accepted again if necessary.
+
+// protected
+// Only a block already resident in the pool is accepted ahead, so that no
+// wait within the critical section can depend upon a block download.
+void organize_block::speculate(block_const_ptr parent, size_t height)
+{
+    const auto block = pool_.take(height);
+
+    if (!block)
+        return;
+
+    // The resident block is not a child of the parent, so return it.
+    if (stopped() || block->header().previous_block_hash() != parent->hash())
+    {
+        pool_.add(block, height);
+        return;
+    }
+
+    const auto next = std::make_shared<speculation>();
+    const auto& metadata = block->header().metadata;
+    next->parent = parent;
+    next->block = block;
+    next->height = height;
+    next->fork_point = fast_chain_.fork_point();
+    next->error = metadata.error;
+    next->validated = metadata.validated;
+    next->state = metadata.state;
+    next->complete = next->accepted.get_future();
+    next_ = next;
+
+    validator_.accept(block, parent->header().metadata.state,
+        std::bind(&organize_block::handle_speculated,
+            this, _1, next));
+}
+
+// private
+void organize_block::handle_speculated(const code& ec, speculation_ptr next)
+{
+    next->accepted.set_value(stopped() ? error::service_stopped : ec);
+}
+
+// protected
+// Wait on acceptance of the next block, discarding it if not accepted.
+void organize_block::settle()
+{
+    if (!next_)
+        return;
+
+    // Unaccepted blocks are validated again sequentially (if reached).
+    if (next_->complete.get())
+        rollback();
+}
+
+// protected
+// Restore the next block to its unaccepted state and clear the pipeline.
+void organize_block::rollback()
+{
+    if (!next_)
+        return;
+
+    const auto next = next_;
+    next_.reset();
+
+    // Acceptance may be in progress and must complete before restoration.
+    // This waits only on validation of a resident block, never a download.
+    if (next->complete.valid())
+        next->complete.wait();
+
+    auto& metadata = next->block->header().metadata;
+    metadata.error = next->error;
+    metadata.validated = next->validated;
+    metadata.state = next->state;
+
+    // Return the block to the pool unless no longer the candidate.
+    if (is_candidate(next->block, next->height))
+        pool_.add(next->block, next->height);
+}
+
 } // namespace blockchain
 } // namespace libbitcoin
@@ -121,6 +121,132 @@ void organize_header::organize(header_const_ptr header,
     validator_.accept(branch, accept_handler);
 }
 
+// This is called from block_chain::organize.
+// The run is accepted header by header, each promoting chain state from its
+// predecessor, and the valid prefix is committed by a single reorganization.
+void organize_header::organize(headers_const_ptr headers,
+    result_handler handler)
+{
+    const auto& elements = headers->elements();
+
+    if (elements.empty())
+    {
+        handler(error::success);
+        return;
+    }
+
+    // Each header of the message must link to its predecessor.
+    if (!headers->is_sequential())
+    {
+        handler(error::invalid_previous_block);
+        return;
+    }
+
+    const auto run = std::make_shared<header_const_ptr_list>();
+    run->reserve(elements.size());
+
+    for (const auto& element: elements)
+        run->push_back(std::make_shared<const message::header>(element));
+
+    const auto check_handler =
+        std::bind(&organize_header::handle_check,
+            this, _1, run, handler);
+
+    // Checks that are independent of chain state (concurrent).
+    validator_.check(run, check_handler);
+}
+
+// private
+void organize_header::handle_check(const code& ec,
+    header_const_ptr_list_const_ptr run, result_handler handler)
+{
+    if (stopped())
+    {
+        handler(error::service_stopped);
+        return;
+    }
+
+    if (ec)
+    {
+        handler(ec);
+        return;
+    }
+
+    code error_code;
+    const result_handler complete =
+        std::bind(&organize_header::handle_complete,
+            this, _1, handler);
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock();
+
+    size_t first = 0;
+    header_branch::ptr branch;
+
+    // Leading headers already pooled or stored (peer overlap) are skipped.
+    for (; first < run->size(); ++first)
+    {
+        // This sets height and presumes the fork point is an candidate header.
+        branch = pool_.get_branch((*run)[first]);
+
+        if (branch->empty())
+            continue;
+
+        if ((error_code = accept(branch)) != error::duplicate_block)
+            break;
+    }
+
+    // The headers are already memory pooled or stored (nothing to do).
+    if (first == run->size())
+    {
+        complete(error::duplicate_block);
+        return;
+    }
+
+    if (error_code)
+    {
+        complete(error_code);
+        return;
+    }
+
+    auto last = first + 1u;
+
+    // Extend the branch, chain state is promoted from the prior top.
+    for (; last < run->size(); ++last)
+    {
+        if (!branch->extend((*run)[last]))
+        {
+            error_code = error::invalid_previous_block;
+            break;
+        }
+
+        if ((error_code = accept(branch)))
+        {
+            branch->pop();
+            break;
+        }
+    }
+
+    if (error_code == error::service_stopped)
+    {
+        complete(error_code);
+        return;
+    }
+
+    // The valid prefix is committed even if a subsequent header is invalid.
+    const auto result = commit(branch, last - first);
+
+    // A header failure takes precedence over insufficient work.
+    if (!result || result == error::insufficient_work)
+    {
+        complete(error_code ? error_code : result);
+        return;
+    }
+
+    complete(result);
+}
+
 // private
 void organize_header::handle_complete(const code& ec, result_handler handler)
 {
@@ -154,23 +280,54 @@ void organize_header::handle_accept(const code& ec, header_branch::ptr branch,
     }
 
     // The top block is valid even if the branch has insufficient work.
-    const auto top = branch->top();
+    handler(commit(branch, 1));
+}
+
+// Utilities.
+//-----------------------------------------------------------------------------
+
+// private
+// Accept the top of the branch, promoting chain state from its parent.
+code organize_header::accept(header_branch::ptr branch)
+{
+    resume_ = {};
+
+    const result_handler complete =
+        std::bind(&organize_header::signal_completion,
+            this, _1);
+
+    // Checks that are dependent on chain state.
+    validator_.accept(branch, complete);
+
+    // Validation failed or received stop code from validator.
+    return resume_.get_future().get();
+}
+
+// private
+void organize_header::signal_completion(const code& ec)
+{
+    resume_.set_value(ec);
+}
+
+// private
+// The top unpooled headers of the branch are pooled if work is insufficient.
+code organize_header::commit(header_branch::ptr branch, size_t unpooled)
+{
     const auto work = branch->work();
     uint256_t required_work;
 
     // This stops before the height or at the work level, which ever is first.
     if (!fast_chain_.get_work(required_work, work, branch->fork_height(), true))
-    {
-        handler(error::operation_failed);
-        return;
-    }
+        return error::operation_failed;
 
     // Consensus.
     if (work <= required_work)
     {
-        pool_.add(top, branch->top_height());
-        handler(error::insufficient_work);
-        return;
+        const auto& headers = *branch->headers();
+        const auto pooled = std::make_shared<header_const_ptr_list>(
+            headers.end() - unpooled, headers.end());
+        pool_.add(pooled, branch->top_height() - unpooled + 1u);
+        return error::insufficient_work;
     }
 
     // This triggers HEADER notifications.
@@ -184,12 +341,9 @@ void organize_header::handle_accept(const code& ec, header_branch::ptr branch,
         LOG_FATAL(LOG_BLOCKCHAIN)
             << "Failure writing header to store, is now corrupted: "
             << error_code.message();
-
-        handler(error_code);
-        return;
     }
 
-    handler(error_code);
+    return error_code;
 }
 
 } // namespace blockchain
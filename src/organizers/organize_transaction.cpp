@@ -41,13 +41,15 @@ using namespace std::placeholders;
 
 organize_transaction::organize_transaction(prioritized_mutex& mutex,
     dispatcher& priority_dispatch, threadpool&, fast_chain& chain,
-    transaction_pool& pool, const settings& settings)
+    transaction_pool& pool, script_cache& cache, metrics_cache& metrics,
+    const settings& settings)
   : fast_chain_(chain),
     mutex_(mutex),
     stopped_(true),
     settings_(settings),
     pool_(pool),
-    validator_(priority_dispatch, fast_chain_, settings)
+    metrics_cache_(metrics),
+    validator_(priority_dispatch, fast_chain_, cache, settings)
 {
 }
 
@@ -237,7 +239,6 @@ void organize_transaction::handle_connect(const code& ec,
 
 bool organize_transaction::sufficient_fee(transaction_const_ptr tx) const
 {
-    static const auto version = message::version::level::canonical;
     const auto byte_fee = settings_.byte_fee_satoshis;
     const auto sigop_fee = settings_.sigop_fee_satoshis;
 
@@ -245,12 +246,24 @@ bool organize_transaction::sufficient_fee(transaction_const_ptr tx) const
     if (byte_fee == 0.0f && sigop_fee == 0.0f)
         return true;
 
+    // Populated by accept, required for sigop rules.
+    const auto state = tx->metadata.state;
+
     // TODO: incorporate tx weight discount.
-    // TODO: incorporate bip16 and bip141 in sigops parmaterization.
-    // TODO: this is a second pass on size and sigops, implement cache.
-    // This at least prevents uncached calls when zero fee is configured.
-    auto byte = byte_fee > 0 ? byte_fee * tx->serialized_size(version) : 0;
-    auto sigop = sigop_fee > 0 ? sigop_fee * tx->signature_operations() : 0;
+    // Computed once per tx and sigop rules, shared with block validation.
+    // Without state the metrics are computed uncached, as before the cache.
+    const auto metrics = state ?
+        metrics_cache_.add(*tx,
+            state->is_enabled(rule_fork::bip16_rule),
+            state->is_enabled(rule_fork::bip141_rule)) :
+        metrics_cache::metrics
+        {
+            tx->serialized_size(message::version::level::canonical),
+            tx->signature_operations()
+        };
+
+    auto byte = byte_fee > 0 ? byte_fee * metrics.size : 0;
+    auto sigop = sigop_fee > 0 ? sigop_fee * metrics.sigops : 0;
 
     // Require at least one satoshi per tx if there are any fees configured.
     auto price = std::max(uint64_t(1), static_cast<uint64_t>(byte + sigop));
@@ -260,13 +273,12 @@ bool organize_transaction::sufficient_fee(transaction_const_ptr tx) const
     if (paid >= price)
         return true;
 
-    // TODO: optimize out second serialized_size signature_operations calls.
     LOG_DEBUG(LOG_BLOCKCHAIN)
         << "Transaction [" << encode_hash(tx->hash()) << "] "
-        << "bytes: " << tx->serialized_size(version) << " "
-        << "sigops: " << tx->signature_operations() << " "
+        << "bytes: " << metrics.size << " "
+        << "sigops: " << metrics.sigops << " "
         << "price: " << price << " "
-        << "paid: " << tx->fees();
+        << "paid: " << paid;
 
     return false;
 }
@@ -20,11 +20,13 @@
 
 #include <cstddef>
 #include <functional>
+#include <unordered_set>
 #include <utility>
 #include <bitcoin/blockchain.hpp>
 #include <bitcoin/blockchain/interface/fast_chain.hpp>
 #include <bitcoin/blockchain/pools/block_entry.hpp>
 #include <bitcoin/blockchain/settings.hpp>
+#include <boost/functional/hash.hpp>
 
 namespace libbitcoin {
 namespace blockchain {
@@ -170,6 +172,37 @@ block_const_ptr block_pool::get(size_t height)
     return chain_.get_candidate(height);
 }
 
+block_const_ptr block_pool::take(size_t height)
+{
+    if (maximum_size_ == 0)
+        return {};
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock_upgrade();
+
+    auto& cached = blocks_.right;
+    const auto it = cached.find(height);
+
+    if (it != cached.end())
+    {
+        const auto block = it->second.block();
+
+        mutex_.unlock_upgrade_and_lock();
+        //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        cached.erase(it);
+        //---------------------------------------------------------------------
+        mutex_.unlock();
+
+        return block;
+    }
+
+    mutex_.unlock_upgrade();
+    ///////////////////////////////////////////////////////////////////////////
+
+    return {};
+}
+
 void block_pool::fetch(size_t height, read_handler&& handler)
 {
     // The cache is disabled, just read and return the block.
@@ -258,6 +291,47 @@ void block_pool::read_block(size_t height)
     ///////////////////////////////////////////////////////////////////////////
 
     subscriber_->relay(ec, block, height);
+
+    // Warm prevouts of the buffered block ahead of its validation.
+    if (block)
+        dispatch_.concurrent(&block_pool::prefetch, this, block);
+}
+
+// protected
+// Prevouts are read into the chain's utxo cache (and store pages) using
+// fresh points, as the block's own metadata is set only by populate. Only
+// confirmed outputs unspent at the fork point are cached, and the cache
+// discards a read that races a spend by a block in the window, so this
+// cannot affect validation results.
+void block_pool::prefetch(block_const_ptr block) const
+{
+    const auto& txs = block->transactions();
+    const auto fork_height = chain_.fork_point().height();
+    std::unordered_set<hash_digest, boost::hash<hash_digest>> internal;
+
+    for (const auto& tx: txs)
+        internal.insert(tx.hash());
+
+    for (const auto& tx: txs)
+    {
+        if (tx.is_coinbase())
+            continue;
+
+        for (const auto& input: tx.inputs())
+        {
+            if (stopped())
+                return;
+
+            const auto& prevout = input.previous_output();
+
+            // Prevouts created within the block are resolved by populate.
+            if (internal.find(prevout.hash()) != internal.end())
+                continue;
+
+            chain::output_point outpoint{ prevout.hash(), prevout.index() };
+            chain_.populate_block_output(outpoint, fork_height);
+        }
+    }
 }
 
 // protected
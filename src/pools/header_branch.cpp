@@ -61,6 +61,24 @@ bool header_branch::push(header_const_ptr header)
     return false;
 }
 
+// Back is the top of the branch, so this appends above the current top.
+bool header_branch::extend(header_const_ptr header)
+{
+    if (empty() || header->previous_block_hash() == headers_->back()->hash())
+    {
+        headers_->push_back(header);
+        return true;
+    }
+
+    return false;
+}
+
+void header_branch::pop()
+{
+    if (!empty())
+        headers_->pop_back();
+}
+
 header_const_ptr header_branch::top_parent() const
 {
     const auto count = size();
@@ -18,6 +18,7 @@
  */
 #include <bitcoin/blockchain/pools/header_entry.hpp>
 
+#include <algorithm>
 #include <cstddef>
 ////#include <iostream>
 #include <bitcoin/system.hpp>
@@ -29,13 +30,23 @@ namespace blockchain {
 using namespace bc::system;
 
 header_entry::header_entry(header_const_ptr header, size_t height)
-  : height_(height), hash_(header->hash()), header_(header)
+  : header_entry(header, height, header->proof(), 0)
+{
+}
+
+header_entry::header_entry(header_const_ptr header, size_t height,
+    const uint256_t& work, size_t sequence)
+  : height_(height),
+    sequence_(sequence),
+    work_(work),
+    hash_(header->hash()),
+    header_(header)
 {
 }
 
 // Create a search key.
 header_entry::header_entry(const hash_digest& hash)
-  : height_(0), hash_(hash)
+  : height_(0), sequence_(0), hash_(hash)
 {
 }
 
@@ -49,6 +60,16 @@ size_t header_entry::height() const
     return height_;
 }
 
+const uint256_t& header_entry::work() const
+{
+    return work_;
+}
+
+size_t header_entry::sequence() const
+{
+    return sequence_;
+}
+
 const hash_digest& header_entry::hash() const
 {
     return hash_;
@@ -74,6 +95,14 @@ void header_entry::add_child(header_const_ptr child) const
     children_.push_back(child->hash());
 }
 
+void header_entry::remove_child(const hash_digest& child) const
+{
+    const auto it = std::find(children_.begin(), children_.end(), child);
+
+    if (it != children_.end())
+        children_.erase(it);
+}
+
 // For the purpose of bimap identity only the header hash matters.
 bool header_entry::operator==(const header_entry& other) const
 {
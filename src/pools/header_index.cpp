@@ -0,0 +1,252 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/blockchain/pools/header_index.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <bitcoin/system.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+using namespace bc::system;
+using namespace bc::system::chain;
+
+header_index::header_index()
+{
+}
+
+size_t header_index::size() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+    return hashes_.size();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void header_index::reserve(size_t size)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+    hashes_.reserve(size);
+    bits_.reserve(size);
+    versions_.reserve(size);
+    timestamps_.reserve(size);
+    work_.reserve(size);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool header_index::get_block_hash(hash_digest& out_hash, size_t height) const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    if (height >= hashes_.size())
+        return false;
+
+    out_hash = hashes_[height];
+    return true;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool header_index::get_bits(uint32_t& out_bits, size_t height) const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    if (height >= bits_.size())
+        return false;
+
+    out_bits = bits_[height];
+    return true;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool header_index::get_version(uint32_t& out_version, size_t height) const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    if (height >= versions_.size())
+        return false;
+
+    out_version = versions_[height];
+    return true;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool header_index::get_timestamp(uint32_t& out_timestamp,
+    size_t height) const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    if (height >= timestamps_.size())
+        return false;
+
+    out_timestamp = timestamps_[height];
+    return true;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// The result is that of summing downward from the top until overcome.
+bool header_index::get_work(uint256_t& out_work, const uint256_t& overcome,
+    size_t above_height, size_t top) const
+{
+    out_work = 0;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    if (top + 1u != work_.size())
+        return false;
+
+    if (above_height >= top)
+        return true;
+
+    const auto& total = work_[top];
+    out_work = total - work_[above_height];
+
+    if (overcome.is_zero() || out_work <= overcome)
+        return true;
+
+    // Find the highest height at or above which the work is not less than
+    // overcome. This is a binary search, as cumulative work never decreases.
+    const uint256_t maximum = total - overcome;
+    const auto first = work_.begin() + above_height;
+    const auto last = work_.begin() + top;
+    const auto it = std::upper_bound(first, last, maximum);
+    out_work = total - *std::prev(it);
+    return true;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void header_index::pop(size_t fork_height)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    if (fork_height + 1u >= hashes_.size())
+        return;
+
+    hashes_.resize(fork_height + 1u);
+    bits_.resize(fork_height + 1u);
+    versions_.resize(fork_height + 1u);
+    timestamps_.resize(fork_height + 1u);
+    work_.resize(fork_height + 1u);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void header_index::push(const header& header, size_t height)
+{
+    const auto hash = header.hash();
+    const auto proof = header.proof();
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    // The index must remain contiguous from genesis.
+    if (height != hashes_.size())
+        return;
+
+    hashes_.push_back(hash);
+    bits_.push_back(header.bits());
+    versions_.push_back(header.version());
+    timestamps_.push_back(header.timestamp());
+    work_.push_back(work_.empty() ? proof : work_.back() + proof);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void header_index::to_data(writer& sink) const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    sink.write_8_bytes_little_endian(hashes_.size());
+
+    for (size_t height = 0; height < hashes_.size(); ++height)
+    {
+        sink.write_hash(hashes_[height]);
+        sink.write_4_bytes_little_endian(bits_[height]);
+        sink.write_4_bytes_little_endian(versions_[height]);
+        sink.write_4_bytes_little_endian(timestamps_[height]);
+    }
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool header_index::from_data(reader& source)
+{
+    const auto count = source.read_8_bytes_little_endian();
+
+    std::vector<hash_digest> hashes;
+    std::vector<uint32_t> bits;
+    std::vector<uint32_t> versions;
+    std::vector<uint32_t> timestamps;
+    std::vector<uint256_t> work;
+
+    // The count is not trusted for reservation, reading stops on failure.
+    for (uint64_t height = 0; source && height < count; ++height)
+    {
+        hashes.push_back(source.read_hash());
+        bits.push_back(source.read_4_bytes_little_endian());
+        versions.push_back(source.read_4_bytes_little_endian());
+        timestamps.push_back(source.read_4_bytes_little_endian());
+
+        // Work is recomputed, as it is implied by bits.
+        const auto proof = header::proof(bits.back());
+        work.push_back(work.empty() ? proof : work.back() + proof);
+    }
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    if (!source)
+    {
+        hashes_.clear();
+        bits_.clear();
+        versions_.clear();
+        timestamps_.clear();
+        work_.clear();
+        return false;
+    }
+
+    hashes_.swap(hashes);
+    bits_.swap(bits);
+    versions_.swap(versions);
+    timestamps_.swap(timestamps);
+    work_.swap(work);
+    return true;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+} // namespace blockchain
+} // namespace libbitcoin
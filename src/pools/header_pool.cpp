@@ -33,9 +33,27 @@ namespace blockchain {
 using namespace bc::system;
 using namespace boost;
 
+// The estimated memory cost of a pooled header (excluding chain state).
+static constexpr size_t entry_bytes = sizeof(header_entry) +
+    sizeof(message::header) + sizeof(hash_digest);
+
+// The estimated memory cost of the chain state retained by a branch tip.
+// This is an upper bound, as chain state holds up to a retarget interval of
+// bits and an activation sample of versions.
+static constexpr size_t state_bytes = sizeof(chain::chain_state) +
+    (2016u + 1000u) * sizeof(uint32_t);
+
+static size_t maximum_bytes(uint64_t bytes)
+{
+    return bytes == 0 ? max_size_t : domain_constrain<size_t>(bytes);
+}
+
 header_pool::header_pool(const settings& settings)
   : maximum_depth_(settings.reorganization_limit == 0 ? max_size_t :
-      settings.reorganization_limit)
+      settings.reorganization_limit),
+    maximum_bytes_(maximum_bytes(settings.header_pool_bytes)),
+    evictions_(0),
+    sequence_(0)
 {
 }
 
@@ -44,6 +62,22 @@ size_t header_pool::size() const
     return headers_.size();
 }
 
+size_t header_pool::bytes() const
+{
+    return size() * entry_bytes + tips_.size() * state_bytes;
+}
+
+size_t header_pool::evictions() const
+{
+    return evictions_;
+}
+
+// protected
+header_pool::tip header_pool::to_tip(const header_entry& entry)
+{
+    return std::make_tuple(entry.work(), entry.sequence(), entry.hash());
+}
+
 // protected
 bool header_pool::exists(const hash_digest& hash) const
 {
@@ -66,7 +100,7 @@ void header_pool::add(header_const_ptr valid_header, size_t height)
 {
     // The header must be successfully validated.
     ////BITCOIN_ASSERT(!valid_header->metadata.error);
-    header_entry entry{ valid_header, height };
+    auto work = valid_header->proof();
     const auto& left = headers_.left;
 
     // Caller ensures the entry does not exist by using exists(), but
@@ -76,22 +110,37 @@ void header_pool::add(header_const_ptr valid_header, size_t height)
     // Add a back pointer from the parent for clearing the path later.
     const header_entry parent{ valid_header->previous_block_hash() };
     const auto it = left.find(parent);
+    const auto root = (it == left.end());
 
     // Add child and clear chain state from internal (parent) node.
-    if (it != left.end())
+    // Only branch tips retain chain state, which is rebuilt on demand by
+    // promotion from the fork point for a branch off of an internal node.
+    if (!root)
     {
-        height = 0;
+        work += it->first.work();
         it->first.add_child(valid_header);
-
-        // Disabling this line ensures all headers retain chain state.
-        ////it->first.header()->metadata.state.reset();
+        it->first.header()->metadata.state.reset();
+        tips_.erase(to_tip(it->first));
     }
 
+    header_entry entry{ valid_header, height, work, sequence_++ };
+    const auto top = to_tip(entry);
+
     // Critical Section
     ///////////////////////////////////////////////////////////////////////////
-    unique_lock lock(mutex_);
-    headers_.insert({ std::move(entry), height });
+    mutex_.lock();
+    const auto inserted = headers_.insert(
+        { std::move(entry), root ? height : 0 }).second;
+    mutex_.unlock();
     ///////////////////////////////////////////////////////////////////////////
+
+    if (inserted)
+        tips_.insert(top);
+
+    // Evict incrementally to remain within the byte budget (retaining one).
+    while (size() > 1u && bytes() > maximum_bytes_)
+        if (!evict())
+            break;
 }
 
 void header_pool::add(header_const_ptr_list_const_ptr valid_headers,
@@ -125,6 +174,7 @@ void header_pool::remove(header_const_ptr_list_const_ptr accepted_headers)
         // Copy hashes of all children of nodes we delete.
         const auto& children = it->first.children();
         std::for_each(children.begin(), children.end(), saver);
+        tips_.erase(to_tip(it->first));
 
         ///////////////////////////////////////////////////////////////////////
         // Critical Section
@@ -175,6 +225,7 @@ void header_pool::prune(const hash_list& hashes, size_t minimum_height)
             // delete
             const auto& children = it->first.children();
             std::for_each(children.begin(), children.end(), saver);
+            tips_.erase(to_tip(it->first));
 
             ///////////////////////////////////////////////////////////////////
             // Critical Section
@@ -203,18 +254,79 @@ void header_pool::prune(const hash_list& hashes, size_t minimum_height)
 
 void header_pool::prune(size_t top_height)
 {
-    hash_list hashes;
+    hash_list child_hashes;
+    auto saver = [&](const hash_digest& hash){ child_hashes.push_back(hash); };
     const auto minimum_height = floor_subtract(top_height, maximum_depth_);
 
-    // TODO: not using table sort here, should stop iterating once above min.
-    // Iterate over all root nodes with insufficient height.
-    for (auto it: headers_.right)
-        if (it.first != 0 && it.first < minimum_height)
-            hashes.push_back(it.second.hash());
+    // Non-root nodes have zero height, so no root can be below one.
+    if (minimum_height <= 1u)
+        return;
+
+    // The root index is height ordered, so expired roots are a single range.
+    auto& right = headers_.right;
+    const auto begin = right.upper_bound(0);
+    const auto end = right.lower_bound(minimum_height);
+
+    if (begin == end)
+        return;
+
+    // Copy hashes of all children of roots we delete.
+    for (auto it = begin; it != end; ++it)
+    {
+        const auto& children = it->second.children();
+        std::for_each(children.begin(), children.end(), saver);
+        tips_.erase(to_tip(it->second));
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock();
+    right.erase(begin, end);
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Delete expired children and replant the others as roots.
+    if (!child_hashes.empty())
+        prune(child_hashes, minimum_height);
+}
+
+// protected
+// Evict the branch tip of least work (oldest first), exposing its parent.
+bool header_pool::evict()
+{
+    if (tips_.empty())
+        return false;
+
+    const auto weakest = tips_.begin();
+    const auto hash = std::get<2>(*weakest);
+    tips_.erase(weakest);
+
+    auto& left = headers_.left;
+    const auto it = left.find(header_entry{ hash });
+
+    // A tip with children would orphan them, so it is just dropped as a tip.
+    if (it == left.end() || !it->first.children().empty())
+        return true;
+
+    const auto parent = left.find(header_entry{ it->first.parent() });
+
+    if (parent != left.end())
+    {
+        parent->first.remove_child(hash);
+
+        if (parent->first.children().empty())
+            tips_.insert(to_tip(parent->first));
+    }
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock();
+    left.erase(it);
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
 
-    // Get outside of the hash table iterator before deleting.
-    if (!hashes.empty())
-        prune(hashes, minimum_height);
+    ++evictions_;
+    return true;
 }
 
 // This is guarded against concurrent write (the only reason for the mutex).
@@ -0,0 +1,221 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/blockchain/pools/header_window.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <bitcoin/system.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+using namespace bc::system;
+using namespace bc::system::chain;
+
+header_window::header_window(size_t capacity)
+  : capacity_(capacity),
+    top_(0),
+    count_(0),
+    entries_(capacity)
+{
+}
+
+size_t header_window::capacity() const
+{
+    return capacity_;
+}
+
+size_t header_window::size() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+    return count_;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool header_window::get_block_hash(hash_digest& out_hash, size_t height) const
+{
+    entry value;
+    if (!find(value, height))
+        return false;
+
+    out_hash = value.hash;
+    return true;
+}
+
+bool header_window::get_bits(uint32_t& out_bits, size_t height) const
+{
+    entry value;
+    if (!find(value, height))
+        return false;
+
+    out_bits = value.bits;
+    return true;
+}
+
+bool header_window::get_version(uint32_t& out_version, size_t height) const
+{
+    entry value;
+    if (!find(value, height))
+        return false;
+
+    out_version = value.version;
+    return true;
+}
+
+bool header_window::get_timestamp(uint32_t& out_timestamp,
+    size_t height) const
+{
+    entry value;
+    if (!find(value, height))
+        return false;
+
+    out_timestamp = value.timestamp;
+    return true;
+}
+
+void header_window::pop(size_t fork_height)
+{
+    if (capacity_ == 0)
+        return;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock();
+
+    if (count_ != 0 && fork_height < top_)
+    {
+        const auto popped = top_ - fork_height;
+        count_ = popped < count_ ? count_ - popped : 0;
+        top_ = fork_height;
+    }
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void header_window::push(const header& header, size_t height)
+{
+    if (capacity_ == 0)
+        return;
+
+    entry value
+    {
+        header.hash(),
+        header.bits(),
+        header.version(),
+        header.timestamp()
+    };
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock();
+
+    // A gap or overlap invalidates the window, so start over from here.
+    if (count_ != 0 && height != top_ + 1u)
+        count_ = 0;
+
+    entries_[height % capacity_] = value;
+    count_ = std::min(count_ + 1u, capacity_);
+    top_ = height;
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void header_window::to_data(writer& sink) const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    sink.write_8_bytes_little_endian(capacity_);
+    sink.write_8_bytes_little_endian(top_);
+    sink.write_8_bytes_little_endian(count_);
+
+    // Write from the lowest height to the top.
+    for (auto height = top_ + 1u - count_; height <= top_; ++height)
+    {
+        const auto& value = entries_[height % capacity_];
+        sink.write_hash(value.hash);
+        sink.write_4_bytes_little_endian(value.bits);
+        sink.write_4_bytes_little_endian(value.version);
+        sink.write_4_bytes_little_endian(value.timestamp);
+    }
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool header_window::from_data(reader& source)
+{
+    const auto capacity = source.read_8_bytes_little_endian();
+    const auto top = source.read_8_bytes_little_endian();
+    const auto count = source.read_8_bytes_little_endian();
+
+    entries values(capacity_);
+    const auto valid = source && capacity == capacity_ &&
+        count <= capacity_ && top + 1u >= count;
+
+    for (auto height = top + 1u - count; valid && height <= top; ++height)
+    {
+        auto& value = values[height % capacity_];
+        value.hash = source.read_hash();
+        value.bits = source.read_4_bytes_little_endian();
+        value.version = source.read_4_bytes_little_endian();
+        value.timestamp = source.read_4_bytes_little_endian();
+    }
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    if (!valid || !source)
+    {
+        count_ = 0;
+        return false;
+    }
+
+    top_ = top;
+    count_ = count;
+    entries_.swap(values);
+    return true;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// private
+bool header_window::find(entry& out_entry, size_t height) const
+{
+    if (capacity_ == 0)
+        return false;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    if (count_ == 0 || height > top_ || top_ - height >= count_)
+        return false;
+
+    out_entry = entries_[height % capacity_];
+    return true;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+} // namespace blockchain
+} // namespace libbitcoin
@@ -37,11 +37,21 @@ inline uint32_t cap(size_t value)
 }
 
 // TODO: incorporate tx weight.
-// TODO: implement size, sigops, and fees caching on chain::transaction.
+// TODO: implement fees caching on chain::transaction.
 // This requires the full population of transaction.metadata metadata.
 transaction_entry::transaction_entry(transaction_const_ptr tx)
- : size_(cap(tx->serialized_size(message::version::level::canonical))),
-   sigops_(cap(tx->signature_operations())),
+ : transaction_entry(tx,
+     {
+         tx->serialized_size(message::version::level::canonical),
+         tx->signature_operations()
+     })
+{
+}
+
+transaction_entry::transaction_entry(transaction_const_ptr tx,
+    const metrics_cache::metrics& metrics)
+ : size_(cap(metrics.size)),
+   sigops_(cap(metrics.sigops)),
    fees_(tx->fees()),
    forks_(tx->metadata.state->enabled_forks()),
    hash_(tx->hash()),
@@ -0,0 +1,304 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/blockchain/pools/transaction_filter.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <bitcoin/system.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+using namespace bc::system;
+
+// Each bucket holds four 16 bit fingerprints (zero is an empty slot).
+// This yields a false positive rate of about 0.012% at full load.
+static constexpr size_t bucket_slots = 4;
+static constexpr size_t bucket_bytes = bucket_slots * sizeof(uint16_t);
+static constexpr size_t maximum_kicks = 500;
+static constexpr uint32_t alternate_multiplier = 0x5bd1e995;
+
+// The largest power of two number of buckets within the size limit.
+static size_t to_buckets(size_t maximum_bytes)
+{
+    const auto limit = maximum_bytes / bucket_bytes;
+
+    if (limit == 0)
+        return 0;
+
+    size_t buckets = 1;
+    while (buckets <= limit / 2)
+        buckets *= 2;
+
+    return buckets;
+}
+
+transaction_filter::transaction_filter(size_t maximum_bytes)
+  : buckets_(to_buckets(maximum_bytes)),
+    queries_(0),
+    negatives_(0),
+    size_(0),
+    kicks_(0),
+    saturated_(buckets_ == 0),
+    slots_(buckets_ * bucket_slots, 0)
+{
+}
+
+size_t transaction_filter::size() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+    return size_;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+size_t transaction_filter::bytes() const
+{
+    return buckets_ * bucket_bytes;
+}
+
+bool transaction_filter::saturated() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+    return saturated_;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool transaction_filter::contains(const hash_digest& hash) const
+{
+    const auto value = to_fingerprint(hash);
+    const auto bucket = to_bucket(hash);
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock_shared();
+    const auto found = saturated_ || find(bucket, value) ||
+        find(to_alternate(bucket, value), value);
+    mutex_.unlock_shared();
+    ///////////////////////////////////////////////////////////////////////////
+
+    ++queries_;
+
+    if (!found)
+        ++negatives_;
+
+    return found;
+}
+
+void transaction_filter::add(const hash_digest& hash)
+{
+    const auto value = to_fingerprint(hash);
+    const auto bucket = to_bucket(hash);
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock_upgrade();
+
+    // A matching fingerprint already answers positively for this hash.
+    if (saturated_ || find(bucket, value) ||
+        find(to_alternate(bucket, value), value))
+    {
+        mutex_.unlock_upgrade();
+        //---------------------------------------------------------------------
+        return;
+    }
+
+    mutex_.unlock_upgrade_and_lock();
+    //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+    // A failed insert has displaced some fingerprint, so all must match.
+    if (insert(bucket, value))
+        ++size_;
+    else
+        saturated_ = true;
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void transaction_filter::clear()
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock();
+    std::fill(slots_.begin(), slots_.end(), 0);
+    saturated_ = (buckets_ == 0);
+    size_ = 0;
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void transaction_filter::saturate()
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+    saturated_ = true;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void transaction_filter::to_data(writer& sink) const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    sink.write_8_bytes_little_endian(buckets_);
+    sink.write_8_bytes_little_endian(size_);
+    sink.write_byte(saturated_ ? 1 : 0);
+
+    for (const auto slot: slots_)
+        sink.write_2_bytes_little_endian(slot);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool transaction_filter::from_data(reader& source)
+{
+    const auto buckets = source.read_8_bytes_little_endian();
+    const auto size = source.read_8_bytes_little_endian();
+    const auto saturated = source.read_byte() != 0;
+
+    if (!source || buckets != buckets_)
+        return false;
+
+    slots values(slots_.size());
+
+    for (auto& slot: values)
+        slot = source.read_2_bytes_little_endian();
+
+    if (!source)
+        return false;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+    size_ = static_cast<size_t>(size);
+    saturated_ = saturated || buckets_ == 0;
+    slots_ = std::move(values);
+    return true;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+double transaction_filter::false_positive_rate() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock_shared();
+    const auto saturated = saturated_;
+    const auto size = size_;
+    mutex_.unlock_shared();
+    ///////////////////////////////////////////////////////////////////////////
+
+    if (saturated)
+        return 1.0;
+
+    // Each query compares against the occupied slots of two buckets.
+    const auto load = static_cast<double>(size) / (buckets_ * bucket_slots);
+    const auto miss = 1.0 - 1.0 / (max_uint16 + 1.0);
+    return 1.0 - std::pow(miss, 2.0 * bucket_slots * load);
+}
+
+size_t transaction_filter::queries() const
+{
+    return queries_;
+}
+
+size_t transaction_filter::negatives() const
+{
+    return negatives_;
+}
+
+// private
+// Transaction hashes are uniformly distributed, so are used directly.
+transaction_filter::fingerprint transaction_filter::to_fingerprint(
+    const hash_digest& hash)
+{
+    const auto value = from_little_endian_unsafe<fingerprint>(
+        hash.begin() + sizeof(uint64_t));
+
+    // Zero denotes an empty slot.
+    return value == 0 ? 1 : value;
+}
+
+// private
+size_t transaction_filter::to_bucket(const hash_digest& hash) const
+{
+    if (buckets_ == 0)
+        return 0;
+
+    return from_little_endian_unsafe<uint64_t>(hash.begin()) & (buckets_ - 1);
+}
+
+// private
+// The alternate of the alternate bucket is the original bucket.
+size_t transaction_filter::to_alternate(size_t bucket, fingerprint value) const
+{
+    if (buckets_ == 0)
+        return 0;
+
+    return (bucket ^ (value * alternate_multiplier)) & (buckets_ - 1);
+}
+
+// private
+// Call only from within a shared critical section.
+bool transaction_filter::find(size_t bucket, fingerprint value) const
+{
+    const auto begin = slots_.begin() + bucket * bucket_slots;
+    return std::find(begin, begin + bucket_slots, value) !=
+        begin + bucket_slots;
+}
+
+// private
+// Call only from within a unique critical section.
+bool transaction_filter::insert(size_t bucket, fingerprint value)
+{
+    auto alternate = to_alternate(bucket, value);
+
+    for (size_t kick = 0; kick < maximum_kicks; ++kick)
+    {
+        for (const auto candidate: { bucket, alternate })
+        {
+            const auto begin = slots_.begin() + candidate * bucket_slots;
+            const auto it = std::find(begin, begin + bucket_slots, 0);
+
+            if (it != begin + bucket_slots)
+            {
+                *it = value;
+                return true;
+            }
+        }
+
+        // Both buckets are full, evict a resident to its alternate bucket.
+        auto& slot = slots_[alternate * bucket_slots + kicks_++ % bucket_slots];
+        std::swap(slot, value);
+        bucket = alternate;
+        alternate = to_alternate(bucket, value);
+    }
+
+    return false;
+}
+
+} // namespace blockchain
+} // namespace libbitcoin
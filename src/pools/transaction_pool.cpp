@@ -44,9 +44,10 @@ using namespace bc::system;
 
 transaction_pool::priority anchor_priority = 0.0;
 
-transaction_pool::transaction_pool(const settings& )
-  ////: reject_conflicts_(settings.reject_conflicts),
-  ////  minimum_fee_(settings.minimum_fee_satoshis)
+transaction_pool::transaction_pool(const settings& , metrics_cache& metrics)
+  : metrics_(metrics)
+  ////reject_conflicts_(settings.reject_conflicts),
+  ////minimum_fee_(settings.minimum_fee_satoshis)
 {
 }
 
@@ -113,7 +114,14 @@ void transaction_pool::add_unconfirmed_transactions(
         if (tx->inputs().size() > max_uint32)
             continue;
 
-        const auto unconfirmed_entry = std::make_shared<transaction_entry>(tx);
+        // Size and sigops are cached by fee policy under the tx state rules.
+        const auto& state = *tx->metadata.state;
+        const auto metrics = metrics_.add(*tx,
+            state.is_enabled(machine::rule_fork::bip16_rule),
+            state.is_enabled(machine::rule_fork::bip141_rule));
+
+        const auto unconfirmed_entry = std::make_shared<transaction_entry>(tx,
+            metrics);
 
         // Add/retrieve anchors for each transaction
         for (const auto& input: tx->inputs())
@@ -0,0 +1,308 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/blockchain/pools/utxo_cache.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_set>
+#include <utility>
+#include <bitcoin/system.hpp>
+#include <boost/functional/hash.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+using namespace bc::system;
+using namespace bc::system::chain;
+
+// Approximate per output overhead of the key, entry and container nodes.
+static constexpr size_t entry_overhead = 160;
+
+utxo_cache::utxo_cache(size_t maximum_bytes)
+  : maximum_bytes_(maximum_bytes),
+    hits_(0),
+    misses_(0),
+    bytes_(0),
+    removals_(0)
+{
+}
+
+size_t utxo_cache::size() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+    return entries_.size();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+size_t utxo_cache::bytes() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+    return bytes_;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// Sets metadata as the store would for a confirmed and unspent output.
+bool utxo_cache::populate(const output_point& outpoint,
+    size_t fork_height) const
+{
+    if (maximum_bytes_ == 0)
+        return false;
+
+    auto& prevout = outpoint.metadata;
+    const auto value = to_key(outpoint);
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock_shared();
+    const auto it = entries_.find(value);
+
+    // An output above the fork point is not confirmed in the candidate chain.
+    const auto found = it != entries_.end() && it->second.height <= fork_height;
+
+    if (found)
+    {
+        const auto& item = it->second;
+        prevout.candidate = item.candidate;
+        prevout.confirmed = true;
+        prevout.candidate_spent = false;
+        prevout.confirmed_spent = false;
+        prevout.height = item.height;
+        prevout.median_time_past = item.median_time_past;
+        prevout.coinbase = item.coinbase;
+        prevout.cache = item.output;
+    }
+
+    mutex_.unlock_shared();
+    ///////////////////////////////////////////////////////////////////////////
+
+    if (found)
+        ++hits_;
+    else
+        ++misses_;
+
+    return found;
+}
+
+size_t utxo_cache::sequence() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+    return removals_;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void utxo_cache::add(const output_point& outpoint, size_t fork_height,
+    size_t sequence)
+{
+    if (maximum_bytes_ == 0)
+        return;
+
+    const auto& prevout = outpoint.metadata;
+
+    // Only outputs that are confirmed and spent in neither chain are cached.
+    if (!prevout.confirmed || prevout.candidate_spent ||
+        prevout.confirmed_spent || prevout.height > fork_height ||
+        !prevout.cache.is_valid())
+        return;
+
+    entry item
+    {
+        prevout.cache,
+        prevout.height,
+        prevout.median_time_past,
+        prevout.coinbase,
+        prevout.candidate,
+        to_bytes(prevout.cache),
+        {}
+    };
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock();
+
+    // A removal since the store read may have made the prevout stale.
+    if (sequence == removals_)
+        insert(to_key(outpoint), std::move(item));
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void utxo_cache::add(const block& block, size_t height)
+{
+    if (maximum_bytes_ == 0)
+        return;
+
+    const auto median_time_past = block.header().metadata.median_time_past;
+    const auto& txs = block.transactions();
+
+    // Outputs spent within the block are not unspent once it is confirmed.
+    std::unordered_set<key, key_hash> spent;
+    for (auto tx = txs.begin(); tx != txs.end(); ++tx)
+        if (!tx->is_coinbase())
+            for (const auto& input: tx->inputs())
+                spent.insert(to_key(input.previous_output()));
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock();
+
+    for (auto tx = txs.begin(); tx != txs.end(); ++tx)
+    {
+        const auto hash = tx->hash();
+        const auto coinbase = tx == txs.begin();
+        const auto& outputs = tx->outputs();
+
+        for (uint32_t index = 0; index < outputs.size(); ++index)
+        {
+            const auto& output = outputs[index];
+            const key value{ hash, index };
+
+            // Unspendable outputs would never be removed by a spend.
+            if (output.script().is_unspendable() ||
+                spent.find(value) != spent.end())
+                continue;
+
+            insert(value, entry
+            {
+                output, height, median_time_past, coinbase, false,
+                to_bytes(output), {}
+            });
+        }
+    }
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void utxo_cache::remove_spent(const block& block)
+{
+    if (maximum_bytes_ == 0)
+        return;
+
+    const auto& txs = block.transactions();
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock();
+    ++removals_;
+
+    for (auto tx = txs.begin(); tx != txs.end(); ++tx)
+        if (!tx->is_coinbase())
+            for (const auto& input: tx->inputs())
+                erase(to_key(input.previous_output()));
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void utxo_cache::remove_created(const block& block)
+{
+    if (maximum_bytes_ == 0)
+        return;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock();
+    ++removals_;
+
+    for (const auto& tx: block.transactions())
+    {
+        const auto hash = tx.hash();
+        const auto outputs = tx.outputs().size();
+
+        for (uint32_t index = 0; index < outputs; ++index)
+            erase({ hash, index });
+    }
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+size_t utxo_cache::hits() const
+{
+    return hits_;
+}
+
+size_t utxo_cache::misses() const
+{
+    return misses_;
+}
+
+// private
+// Call only from within a unique critical section.
+void utxo_cache::insert(const key& value, entry&& item)
+{
+    if (entries_.find(value) != entries_.end())
+        return;
+
+    item.position = insertions_.insert(insertions_.end(), value);
+    bytes_ += item.bytes;
+    entries_.emplace(value, std::move(item));
+
+    // Evict the oldest outputs, which are the least likely to be spent.
+    while (bytes_ > maximum_bytes_ && !insertions_.empty())
+        erase(insertions_.front());
+}
+
+// private
+// Call only from within a unique critical section.
+void utxo_cache::erase(const key& value)
+{
+    const auto it = entries_.find(value);
+
+    if (it == entries_.end())
+        return;
+
+    bytes_ -= it->second.bytes;
+    insertions_.erase(it->second.position);
+    entries_.erase(it);
+}
+
+// private
+utxo_cache::key utxo_cache::to_key(const point& point)
+{
+    return { point.hash(), point.index() };
+}
+
+// private
+size_t utxo_cache::to_bytes(const output& output)
+{
+    return entry_overhead + output.serialized_size(false);
+}
+
+bool utxo_cache::key::operator==(const key& other) const
+{
+    return index == other.index && hash == other.hash;
+}
+
+size_t utxo_cache::key_hash::operator()(const key& value) const
+{
+    auto seed = boost::hash<hash_digest>()(value.hash);
+    boost::hash_combine(seed, value.index);
+    return seed;
+}
+
+} // namespace blockchain
+} // namespace libbitcoin
@@ -22,6 +22,10 @@
 #include <cstddef>
 #include <cstdint>
 #include <iterator>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <boost/functional/hash.hpp>
 #include <bitcoin/system.hpp>
 #include <bitcoin/blockchain/interface/fast_chain.hpp>
 
@@ -46,9 +50,16 @@ void populate_block::populate(block_const_ptr block,
     result_handler&& handler) const
 {
     // This candidate must be that which follows the top valid candidate.
+    populate(block, fast_chain_.top_valid_candidate_state(),
+        std::move(handler));
+}
+
+// Returns store code only.
+void populate_block::populate(block_const_ptr block,
+    chain_state::ptr parent, result_handler&& handler) const
+{
     auto& metadata = block->header().metadata;
-    const auto top_valid = fast_chain_.top_valid_candidate_state();
-    metadata.state = fast_chain_.promote_state(block->header(), top_valid);
+    metadata.state = fast_chain_.promote_state(block->header(), parent);
 
     if (!metadata.state)
     {
@@ -86,16 +97,99 @@ void populate_block::populate_non_coinbase(block_const_ptr block,
         return;
     }
 
+    const auto groups = group_prevouts(block);
     const auto buckets = std::min(dispatch_.size(), non_coinbase_inputs);
     const auto join_handler = synchronize(std::move(handler), buckets, NAME);
     BITCOIN_ASSERT(buckets != 0);
 
     for (size_t bucket = 0; bucket < buckets; ++bucket)
         dispatch_.concurrent(&populate_block::populate_transactions,
-            this, block, fork_height, bucket, buckets, populate_txs,
+            this, block, groups, fork_height, bucket, buckets, populate_txs,
                 join_handler);
 }
 
+// Prevouts of txs earlier in the block are populated here from the block.
+// Remaining non-coinbase prevouts are grouped by parent tx hash. The store
+// populates one output per call, so each distinct outpoint is still one
+// lookup. Ordering a group by output index makes a duplicated outpoint
+// (double spend) adjacent, so that it is looked up only once.
+populate_block::prevout_groups_ptr populate_block::group_prevouts(
+    block_const_ptr block)
+{
+    typedef std::unordered_map<hash_digest, size_t, boost::hash<hash_digest>>
+        position_map;
+
+    const auto groups = std::make_shared<prevout_groups>();
+    const auto& state = *block->header().metadata.state;
+    const auto& txs = block->transactions();
+    position_map positions;
+    position_map parents;
+
+    // The coinbase may be spent within the block (but is immature).
+    positions.emplace(txs.front().hash(), 0);
+
+    // Must skip coinbase here as it is already accounted for.
+    for (auto tx = std::next(txs.begin()); tx != txs.end(); ++tx)
+    {
+        for (const auto& input: tx->inputs())
+        {
+            const auto& prevout = input.previous_output();
+            const auto internal = positions.find(prevout.hash());
+
+            if (internal != positions.end())
+            {
+                const auto position = internal->second;
+                populate_internal(prevout, txs[position], position == 0,
+                    state);
+                continue;
+            }
+
+            const auto entry = parents.emplace(prevout.hash(), groups->size());
+
+            if (entry.second)
+                groups->emplace_back();
+
+            (*groups)[entry.first->second].push_back(&prevout);
+        }
+
+        // Added after inputs, as a forward or self reference is external.
+        positions.emplace(tx->hash(),
+            static_cast<size_t>(std::distance(txs.begin(), tx)));
+    }
+
+    const auto ascending = [](const output_point* left,
+        const output_point* right)
+    {
+        return left->index() < right->index();
+    };
+
+    // Stable sort keeps duplicates adjacent and in block order.
+    for (auto& group: *groups)
+        std::stable_sort(group.begin(), group.end(), ascending);
+
+    return groups;
+}
+
+// Populate a prevout that spends an earlier tx of the block being validated.
+// The output is in the candidate chain at the block height and is unspent,
+// as a double spend within the block is rejected by block acceptance.
+void populate_block::populate_internal(const output_point& prevout,
+    const transaction& parent, bool coinbase, const chain_state& state)
+{
+    auto& metadata = prevout.metadata;
+    const auto& outputs = parent.outputs();
+    const auto index = prevout.index();
+
+    metadata.candidate = true;
+    metadata.confirmed = false;
+    metadata.candidate_spent = false;
+    metadata.confirmed_spent = false;
+    metadata.height = state.height();
+    metadata.coinbase = coinbase;
+    metadata.median_time_past = state.median_time_past();
+    metadata.cache = index < outputs.size() ? outputs[index] : output{};
+}
+
 // Initialize the coinbase input for subsequent metadata.
 void populate_block::populate_coinbase(block_const_ptr block,
     size_t fork_height) const
@@ -128,14 +222,13 @@ void populate_block::populate_coinbase(block_const_ptr block,
 }
 
 void populate_block::populate_transactions(block_const_ptr block,
-    size_t fork_height, size_t bucket, size_t buckets, bool populate_txs,
-    result_handler handler) const
+    prevout_groups_ptr groups, size_t fork_height, size_t bucket,
+    size_t buckets, bool populate_txs, result_handler handler) const
 {
     BITCOIN_ASSERT(bucket < buckets);
     const auto& txs = block->transactions();
     const auto state = block->header().metadata.state;
     const auto forks = state->enabled_forks();
-    size_t input_position = 0;
 
     if (populate_txs)
     {
@@ -148,26 +241,85 @@ void populate_block::populate_transactions(block_const_ptr block,
         }
     }
 
-    // Must skip coinbase here as it is already accounted for.
-    for (auto tx = std::next(txs.begin()); tx != txs.end(); ++tx)
+    for (auto group = bucket; group < groups->size();
+        group = ceiling_add(group, buckets))
     {
-        const auto& inputs = tx->inputs();
+        const output_point* previous = nullptr;
 
-        for (size_t input_index = 0; input_index < inputs.size();
-            ++input_index, ++input_position)
+        for (const auto prevout: (*groups)[group])
         {
-            if (input_position % buckets != bucket)
-                continue;
-
-            const auto& prevout = inputs[input_index].previous_output();
-
+            // A duplicated outpoint shares the metadata of the first lookup.
             // Don't fail here if output is missing, populate all.
-            /*bool*/ fast_chain_.populate_block_output(prevout, fork_height);
+            if (previous != nullptr && *previous == *prevout)
+                prevout->metadata = previous->metadata;
+            else
+                /*bool*/ fast_chain_.populate_block_output(*prevout,
+                    fork_height);
+
+            previous = prevout;
         }
     }
 
     handler(error::success);
 }
 
+// Metadata that references the parent (created or spent by it) may be stale
+// if populated before the parent was committed as a candidate. Other metadata
+// is unaffected by that commit. A confirmed reorganization moves the fork
+// point, after which the caller must populate the block fully.
+bool populate_block::repopulate(block_const_ptr block,
+    block_const_ptr parent) const
+{
+    typedef std::unordered_set<hash_digest, boost::hash<hash_digest>> hashes;
+
+    const auto state = block->header().metadata.state;
+
+    if (!state)
+        return false;
+
+    // Conservatively match spent outputs by transaction hash.
+    hashes references;
+    for (const auto& tx: parent->transactions())
+    {
+        references.insert(tx.hash());
+
+        if (!tx.is_coinbase())
+            for (const auto& input: tx.inputs())
+                references.insert(input.previous_output().hash());
+    }
+
+    auto refreshed = false;
+    const auto forks = state->enabled_forks();
+    const auto fork_height = fast_chain_.fork_point().height();
+    const auto& txs = block->transactions();
+
+    for (auto tx = txs.begin(); tx != txs.end(); ++tx)
+    {
+        if (references.find(tx->hash()) != references.end())
+        {
+            fast_chain_.populate_block_transaction(*tx, forks, fork_height);
+            refreshed = true;
+        }
+
+        // Coinbase prevout metadata is fixed.
+        if (tx == txs.begin())
+            continue;
+
+        for (const auto& input: tx->inputs())
+        {
+            const auto& prevout = input.previous_output();
+
+            if (references.find(prevout.hash()) != references.end())
+            {
+                /*bool*/ fast_chain_.populate_block_output(prevout,
+                    fork_height);
+                refreshed = true;
+            }
+        }
+    }
+
+    return refreshed;
+}
+
 } // namespace blockchain
 } // namespace libbitcoin
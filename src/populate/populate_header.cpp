@@ -72,6 +72,10 @@ bool populate_header::set_branch_state(header_branch::ptr branch) const
     // TODO: assert that this always succeeds if the branch is not solo.
     top_metadata.state = fast_chain_.promote_state(branch);
 
+    // Pooled internal headers do not retain chain state (only tips do).
+    if (!top_metadata.state && branch->size() > 1u)
+        top_metadata.state = rebuild_state(branch);
+
     if (!top_metadata.state && branch->size() > 1u)
         return false;
 
@@ -121,5 +125,27 @@ bool populate_header::set_branch_state(header_branch::ptr branch) const
     return false;
 }
 
+// private
+// Promote chain state from the fork point through each header of the branch.
+chain_state::ptr populate_header::rebuild_state(
+    header_branch::const_ptr branch) const
+{
+    size_t fork_height;
+    chain::header fork_header;
+    const auto fork_hash = branch->fork_hash();
+
+    if (!fast_chain_.get_header(fork_header, fork_height, fork_hash, true))
+        return {};
+
+    // Query and create chain state for fork point (since not top).
+    auto state = fast_chain_.chain_state(fork_header, fork_height);
+
+    // Promotion fails (null state) if the branch is not linked.
+    for (const auto& header: *branch->headers())
+        state = fast_chain_.promote_state(*header, state);
+
+    return state;
+}
+
 } // namespace blockchain
 } // namespace libbitcoin
@@ -29,6 +29,7 @@ settings::settings()
   : cores(0),
     priority(true),
     index_payments(true),
+    index_headers(false),
     use_libconsensus(false),
     byte_fee_satoshis(1),
     sigop_fee_satoshis(100),
@@ -36,6 +37,13 @@ settings::settings()
     notify_limit_hours(24),
     reorganization_limit(0),
     block_buffer_limit(0),
+    script_cache_limit(100000),
+    metrics_cache_limit(50000),
+    utxo_cache_bytes(0),
+    transaction_filter_bytes(0),
+    transaction_filter_rebuild(false),
+    header_pool_bytes(0),
+    pipeline_validation(false),
     difficult(true),
     retarget(true),
     bip16(true),
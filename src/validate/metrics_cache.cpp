@@ -0,0 +1,148 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/blockchain/validate/metrics_cache.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <bitcoin/system.hpp>
+#include <boost/functional/hash.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+using namespace bc::system;
+using namespace bc::system::chain;
+
+metrics_cache::metrics_cache(size_t maximum_size)
+  : maximum_size_(maximum_size),
+    hits_(0),
+    misses_(0)
+{
+}
+
+size_t metrics_cache::size() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+    return entries_.size();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool metrics_cache::find(metrics& out_metrics, const transaction& tx,
+    bool bip16, bool bip141) const
+{
+    if (maximum_size_ == 0)
+        return false;
+
+    const auto value = to_key(tx, bip16, bip141);
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock_shared();
+    const auto it = entries_.find(value);
+    const auto found = it != entries_.end();
+
+    if (found)
+        out_metrics = it->second;
+
+    mutex_.unlock_shared();
+    ///////////////////////////////////////////////////////////////////////////
+
+    if (found)
+        ++hits_;
+    else
+        ++misses_;
+
+    return found;
+}
+
+metrics_cache::metrics metrics_cache::add(const message::transaction& tx,
+    bool bip16, bool bip141)
+{
+    metrics result;
+
+    if (find(result, tx, bip16, bip141))
+        return result;
+
+    // Compute outside of the critical section.
+    static const auto version = message::version::level::canonical;
+    result.size = tx.serialized_size(version);
+    result.sigops = tx.signature_operations(bip16, bip141);
+
+    if (maximum_size_ == 0)
+        return result;
+
+    const auto value = to_key(tx, bip16, bip141);
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock();
+
+    if (entries_.emplace(value, result).second)
+    {
+        insertions_.push_back(value);
+
+        // Evict the oldest transactions, which are the least likely pending.
+        while (insertions_.size() > maximum_size_)
+        {
+            entries_.erase(insertions_.front());
+            insertions_.pop_front();
+        }
+    }
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    return result;
+}
+
+size_t metrics_cache::hits() const
+{
+    return hits_;
+}
+
+size_t metrics_cache::misses() const
+{
+    return misses_;
+}
+
+// private
+// The witness hash commits to the witness, which affects size and sigops.
+metrics_cache::key metrics_cache::to_key(const transaction& tx, bool bip16,
+    bool bip141)
+{
+    return { tx.hash(true), static_cast<uint8_t>(
+        (bip16 ? 1u : 0u) | (bip141 ? 2u : 0u)) };
+}
+
+bool metrics_cache::key::operator==(const key& other) const
+{
+    return rules == other.rules && hash == other.hash;
+}
+
+size_t metrics_cache::key_hash::operator()(const key& value) const
+{
+    auto seed = boost::hash<hash_digest>()(value.hash);
+    boost::hash_combine(seed, value.rules);
+    return seed;
+}
+
+} // namespace blockchain
+} // namespace libbitcoin
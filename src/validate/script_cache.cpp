@@ -0,0 +1,135 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/blockchain/validate/script_cache.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <bitcoin/system.hpp>
+#include <boost/functional/hash.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+using namespace bc::system;
+using namespace bc::system::chain;
+
+script_cache::script_cache(size_t maximum_size)
+  : maximum_size_(maximum_size),
+    hits_(0),
+    misses_(0)
+{
+}
+
+size_t script_cache::size() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock_shared();
+    const auto size = entries_.size();
+    mutex_.unlock_shared();
+    ///////////////////////////////////////////////////////////////////////////
+
+    return size;
+}
+
+bool script_cache::find(const transaction& tx, uint32_t input_index,
+    uint32_t forks) const
+{
+    if (maximum_size_ == 0)
+        return false;
+
+    const auto value = to_key(tx, input_index, forks);
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock_shared();
+    const auto found = entries_.find(value) != entries_.end();
+    mutex_.unlock_shared();
+    ///////////////////////////////////////////////////////////////////////////
+
+    if (found)
+        ++hits_;
+    else
+        ++misses_;
+
+    return found;
+}
+
+void script_cache::add(const transaction& tx, uint32_t input_index,
+    uint32_t forks)
+{
+    if (maximum_size_ == 0)
+        return;
+
+    const auto value = to_key(tx, input_index, forks);
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock();
+
+    if (entries_.insert(value).second)
+    {
+        insertions_.push_back(value);
+
+        // Evict the oldest inputs, which are the least likely to be pending.
+        while (insertions_.size() > maximum_size_)
+        {
+            entries_.erase(insertions_.front());
+            insertions_.pop_front();
+        }
+    }
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+size_t script_cache::hits() const
+{
+    return hits_;
+}
+
+size_t script_cache::misses() const
+{
+    return misses_;
+}
+
+// private
+// The witness hash commits to the witness, so witness malleation is a miss.
+script_cache::key script_cache::to_key(const transaction& tx,
+    uint32_t input_index, uint32_t forks)
+{
+    return { tx.hash(true), input_index, forks };
+}
+
+bool script_cache::key::operator==(const key& other) const
+{
+    return index == other.index && forks == other.forks &&
+        hash == other.hash;
+}
+
+size_t script_cache::key_hash::operator()(const key& value) const
+{
+    auto seed = boost::hash<hash_digest>()(value.hash);
+    boost::hash_combine(seed, value.index);
+    boost::hash_combine(seed, value.forks);
+    return seed;
+}
+
+} // namespace blockchain
+} // namespace libbitcoin
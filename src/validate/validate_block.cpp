@@ -39,12 +39,20 @@ using namespace std::placeholders;
 
 #define NAME "validate_block"
 
+// The number of inputs claimed by a connect worker at one time.
+static constexpr size_t connect_chunk = 4;
+
 validate_block::validate_block(dispatcher& dispatch, const fast_chain& chain,
+    const script_cache& cache, const metrics_cache& metrics,
     const settings& settings, const system::settings& bitcoin_settings)
   : stopped_(true),
     use_libconsensus_(settings.use_libconsensus),
     checkpoints_(settings.checkpoints),
+    assume_valid_(settings.assume_valid),
+    fast_chain_(chain),
     priority_dispatch_(dispatch),
+    script_cache_(cache),
+    metrics_cache_(metrics),
     block_populator_(dispatch, chain, settings.index_payments),
     scrypt_(settings.scrypt_proof_of_work),
     bitcoin_settings_(bitcoin_settings)
@@ -59,6 +67,18 @@ bool validate_block::stopped() const
     return stopped_;
 }
 
+// Candidate ancestors of the assumed valid block are not script validated.
+// All other contextual checks, including prevout and sigop limits, apply.
+bool validate_block::is_assumed_valid(size_t height) const
+{
+    if (assume_valid_.hash() == null_hash || height > assume_valid_.height())
+        return false;
+
+    hash_digest hash;
+    return fast_chain_.get_block_hash(hash, assume_valid_.height(), true) &&
+        hash == assume_valid_.hash();
+}
+
 // Start/stop sequences.
 //-----------------------------------------------------------------------------
 
@@ -119,6 +139,30 @@ void validate_block::accept(block_const_ptr block,
             this, _1, block, asio::steady_clock::now(), handler));
 }
 
+// Populate using the parent state, as the parent may not yet be committed.
+void validate_block::accept(block_const_ptr block, chain_state::ptr parent,
+    result_handler handler) const
+{
+    // Returns store code only.
+    block_populator_.populate(block, parent,
+        std::bind(&validate_block::handle_populated,
+            this, _1, block, asio::steady_clock::now(), handler));
+}
+
+// Repeat acceptance of a block with previously populated metadata.
+void validate_block::accept_populated(block_const_ptr block,
+    result_handler handler) const
+{
+    handle_populated(error::success, block, asio::steady_clock::now(),
+        handler);
+}
+
+bool validate_block::repopulate(block_const_ptr block,
+    block_const_ptr parent) const
+{
+    return block_populator_.repopulate(block, parent);
+}
+
 // Returns store code only.
 void validate_block::handle_populated(const code& ec, block_const_ptr block,
     asio::time_point start_time, result_handler handler) const
@@ -195,18 +239,20 @@ void validate_block::handle_populated(const code& ec, block_const_ptr block,
         return;
     }
 
+    const auto cancel = std::make_shared<cancel_flag>(false);
     const auto join_handler = synchronize(std::move(complete_handler), buckets,
         NAME "_accept");
 
     for (size_t bucket = 0; bucket < buckets; ++bucket)
         priority_dispatch_.concurrent(&validate_block::accept_transactions,
-            this, block, bucket, buckets, sigops, bip16, bip141, join_handler);
+            this, block, bucket, buckets, sigops, cancel, bip16, bip141,
+                join_handler);
 }
 
 // Returns validation code only.
 void validate_block::accept_transactions(block_const_ptr block, size_t bucket,
-    size_t buckets, atomic_counter_ptr sigops, bool bip16, bool bip141,
-    result_handler handler) const
+    size_t buckets, atomic_counter_ptr sigops, cancel_flag_ptr cancel,
+    bool bip16, bool bip141, result_handler handler) const
 {
     code ec;
     const auto& state = *block->header().metadata.state;
@@ -214,13 +260,24 @@ void validate_block::accept_transactions(block_const_ptr block, size_t bucket,
     const auto count = txs.size();
 
     // Run contextual tx non-script checks (not in tx order).
-    for (auto tx = bucket; tx < count && !ec; tx = ceiling_add(tx, buckets))
+    // The join fires on the first error, so other workers just stop.
+    for (auto tx = bucket; tx < count && !ec && !*cancel;
+        tx = ceiling_add(tx, buckets))
     {
         const auto& transaction = txs[tx];
         ec = transaction.accept(state, false);
-        *sigops += transaction.signature_operations(bip16, bip141);
+
+        // Sigops of txs accepted to the pool are cached by fee policy.
+        metrics_cache::metrics metrics;
+        if (metrics_cache_.find(metrics, transaction, bip16, bip141))
+            *sigops += metrics.sigops;
+        else
+            *sigops += transaction.signature_operations(bip16, bip141);
     }
 
+    if (ec)
+        *cancel = true;
+
     handler(ec);
 }
 
@@ -261,7 +318,8 @@ void validate_block::connect(block_const_ptr block,
 
     const auto non_coinbase_inputs = block->total_non_coinbase_inputs();
 
-    if (state->is_under_checkpoint() || non_coinbase_inputs == 0u)
+    if (state->is_under_checkpoint() || non_coinbase_inputs == 0u ||
+        is_assumed_valid(state->height()))
     {
         handler(error::success);
         return;
@@ -281,58 +339,122 @@ void validate_block::connect(block_const_ptr block,
         return;
     }
 
-    // One dedicated thread is required by the validation subscriber.
-    const auto dispatch = std::min(threads - size_t{1}, non_coinbase_inputs);
-    const auto buckets = static_cast<uint32_t>(dispatch);
-
     // Reset statistics for each block (treat coinbase as cached).
     hits_ = 0;
     queries_ = 0;
 
+    // Flatten unverified inputs so that no worker iterates over all inputs.
+    const auto tasks = connect_tasks(block);
+
+    if (!tasks)
+    {
+        complete_handler(error::empty_transaction);
+        return;
+    }
+
+    if (tasks->empty())
+    {
+        complete_handler(error::success);
+        return;
+    }
+
+    // One dedicated thread is required by the validation subscriber.
+    const auto chunks = (tasks->size() + connect_chunk - 1u) / connect_chunk;
+    const auto buckets = std::min(threads - size_t{1}, chunks);
+    const auto cursor = std::make_shared<atomic_counter>(0);
+    const auto cancel = std::make_shared<cancel_flag>(false);
+
     const auto join_handler = synchronize(std::move(complete_handler), buckets,
         NAME "_validate");
 
-    for (uint32_t bucket = 0; bucket < buckets; ++bucket)
+    // Workers claim chunks from the shared cursor until all are taken, so
+    // expensive inputs do not leave one worker holding the join.
+    for (size_t bucket = 0; bucket < buckets; ++bucket)
         priority_dispatch_.concurrent(&validate_block::connect_inputs,
-            this, block, bucket, buckets, join_handler);
+            this, block, tasks, cursor, cancel, join_handler);
 }
 
-// Returns store code only.
-void validate_block::connect_inputs(block_const_ptr block, uint32_t bucket,
-    uint32_t buckets, result_handler handler) const
+// Returns null if an input index cannot be represented.
+validate_block::input_tasks_ptr validate_block::connect_tasks(
+    block_const_ptr block) const
 {
-    const auto state = block->header().metadata.state;
-
-    if (!(bucket < buckets && state))
-    {
-        handler(error::empty_transaction);
-        return;
-    }
-
-    code ec(error::success);
-    const auto forks = state->enabled_forks();
+    const auto forks = block->header().metadata.state->enabled_forks();
     const auto& txs = block->transactions();
-    size_t position = 0;
+    const auto tasks = std::make_shared<input_tasks>();
+    tasks->reserve(block->total_non_coinbase_inputs());
 
     // Must skip coinbase here as it is already accounted for.
     for (auto tx = std::next(txs.begin()); tx != txs.end(); ++tx)
     {
-        ++queries_;
+        const auto inputs = tx->inputs().size();
+        queries_ += inputs;
 
         // The tx exists with current fork state so outputs are validated.
         if (tx->metadata.verified)
         {
-            ++hits_;
+            hits_ += inputs;
             continue;
         }
 
-        // Index required by verify_script signature.
-        uint32_t input_index = 0;
+        // Guards cast below.
+        if (inputs > max_uint32)
+            return {};
+
+        // Shared by all inputs of the tx, so compute before fan-out.
+        data_ptr tx_data;
+        if (use_libconsensus_)
+            tx_data = std::make_shared<const data_chunk>(
+                tx->to_data(true, true));
 
-        for (const auto& input: tx->inputs())
+        for (size_t index = 0; index < inputs; ++index)
         {
-            if (position % buckets != bucket)
+            const auto input_index = static_cast<uint32_t>(index);
+
+            // The input script was verified with current fork state (pool).
+            if (script_cache_.find(*tx, input_index, forks))
+            {
+                ++hits_;
                 continue;
+            }
+
+            tasks->push_back({ &(*tx), input_index, tx_data });
+        }
+    }
+
+    return tasks;
+}
+
+// Returns store code only.
+void validate_block::connect_inputs(block_const_ptr block,
+    input_tasks_ptr tasks, atomic_counter_ptr cursor, cancel_flag_ptr cancel,
+    result_handler handler) const
+{
+    const auto state = block->header().metadata.state;
+
+    if (!state)
+    {
+        handler(error::empty_transaction);
+        return;
+    }
+
+    code ec(error::success);
+    const auto forks = state->enabled_forks();
+    const auto count = tasks->size();
+
+    // Claim the next chunk of inputs until the work list is exhausted.
+    for (auto first = cursor->fetch_add(connect_chunk); first < count && !ec;
+        first = cursor->fetch_add(connect_chunk))
+    {
+        const auto last = std::min(first + connect_chunk, count);
+
+        for (auto position = first; position < last; ++position)
+        {
+            // Another worker has invalidated the block.
+            if (*cancel)
+            {
+                handler(error::success);
+                return;
+            }
 
             if (stopped())
             {
@@ -340,7 +462,10 @@ void validate_block::connect_inputs(block_const_ptr block, uint32_t bucket,
                 return;
             }
 
-            const auto& prevout = input.previous_output();
+            const auto& task = (*tasks)[position];
+            const auto& tx = *task.tx;
+            const auto index = task.input_index;
+            const auto& prevout = tx.inputs()[index].previous_output();
 
             if (!prevout.metadata.cache.is_valid())
             {
@@ -348,35 +473,28 @@ void validate_block::connect_inputs(block_const_ptr block, uint32_t bucket,
                 break;
             }
 
-            const auto index = static_cast<uint32_t>(input_index);
+            ec = task.tx_data ?
+                validate_input::verify_script(tx, *task.tx_data, index, forks,
+                    use_libconsensus_) :
+                validate_input::verify_script(tx, index, forks,
+                    use_libconsensus_);
 
-            if ((ec = validate_input::verify_script(*tx, index, forks,
-                use_libconsensus_)))
+            if (ec)
             {
-                dump(ec, *tx, index, forks, state->height());
+                dump(ec, tx, index, forks, state->height());
                 break;
             }
-
-            // Guards cast above.
-            if (input_index++ == max_uint32)
-            {
-                handler(error::empty_transaction);
-                return;
-            }
-        }
-
-        if (ec)
-        {
-            block->header().metadata.error = ec;
-            const auto height = state->height();
-            break;
         }
     }
 
+    // Only the first failing worker sets the block error.
+    if (ec && !cancel->exchange(true))
+        block->header().metadata.error = ec;
+
     handler(error::success);
 }
 
-// The tx pool cache hit rate.
+// The tx pool and script cache hit rate (by input).
 float validate_block::hit_rate() const
 {
     // These values could overflow or divide by zero, but that's okay.
@@ -389,6 +507,12 @@ void validate_block::handle_connected(const code& ec, block_const_ptr block,
 {
     block->metadata.connect = asio::steady_clock::now() - start_time;
     block->metadata.cache_efficiency = hit_rate();
+
+    LOG_DEBUG(LOG_BLOCKCHAIN)
+        << "Connected [" << encode_hash(block->hash())
+        << "] script cache hits (" << script_cache_.hits() << ") misses ("
+        << script_cache_.misses() << ").";
+
     handler(ec);
 }
 
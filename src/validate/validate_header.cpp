@@ -18,6 +18,8 @@
  */
 #include <bitcoin/blockchain/validate/validate_header.hpp>
 
+#include <algorithm>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
@@ -40,7 +42,8 @@ validate_header::validate_header(dispatcher& dispatch, const fast_chain& chain,
   : stopped_(true),
     header_populator_(dispatch, chain),
     scrypt_(settings.scrypt_proof_of_work),
-    bitcoin_settings_(bitcoin_settings)
+    bitcoin_settings_(bitcoin_settings),
+    dispatch_(dispatch)
 {
 }
 
@@ -76,6 +79,73 @@ code validate_header::check(header_const_ptr header) const
         bitcoin_settings_.proof_of_work_limit, scrypt_);
 }
 
+// The proof of work hashing of a header batch is spread across threads.
+void validate_header::check(header_const_ptr_list_const_ptr headers,
+    result_handler handler) const
+{
+    const auto count = headers->size();
+
+    if (count == 0u)
+    {
+        handler(error::success);
+        return;
+    }
+
+    // One dedicated thread is required by the validation subscriber.
+    const auto threads = dispatch_.size();
+    const auto buckets = std::max(size_t{1},
+        std::min(safe_subtract(threads, size_t{1}), count));
+
+    result_handler complete_handler =
+        std::bind(&validate_header::handle_checked,
+            this, _1, headers, buckets, asio::steady_clock::now(), handler);
+
+    const auto cancel = std::make_shared<cancel_flag>(false);
+    const auto join_handler = synchronize(std::move(complete_handler), buckets,
+        NAME "_check");
+
+    for (size_t bucket = 0; bucket < buckets; ++bucket)
+        dispatch_.concurrent(&validate_header::check_headers,
+            this, headers, bucket, buckets, cancel, join_handler);
+}
+
+// Returns validation code only.
+void validate_header::check_headers(header_const_ptr_list_const_ptr headers,
+    size_t bucket, size_t buckets, cancel_flag_ptr cancel,
+    result_handler handler) const
+{
+    code ec;
+    const auto count = headers->size();
+
+    // Run context free checks (not in header order).
+    // The join fires on the first error, so other workers just stop.
+    for (auto header = bucket; header < count && !ec && !*cancel;
+        header = ceiling_add(header, buckets))
+        ec = check((*headers)[header]);
+
+    if (ec)
+        *cancel = true;
+
+    handler(ec);
+}
+
+void validate_header::handle_checked(const code& ec,
+    header_const_ptr_list_const_ptr headers, size_t buckets,
+    asio::time_point start_time, result_handler handler) const
+{
+    const auto elapsed = std::chrono::duration_cast<asio::microseconds>(
+        asio::steady_clock::now() - start_time).count();
+    const auto count = headers->size();
+    const auto rate = elapsed <= 0 ? 0.0 : count * 1000000.0 / elapsed;
+
+    LOG_DEBUG(LOG_BLOCKCHAIN)
+        << "Checked " << count << " headers on " << buckets << " threads in "
+        << elapsed << " us (" << static_cast<size_t>(rate)
+        << " headers per second).";
+
+    handler(ec);
+}
+
 // Accept sequence.
 //-----------------------------------------------------------------------------
 // These checks require chain state (net height and enabled forks).
@@ -151,20 +151,28 @@ code validate_input::convert_result(verify_result_type result)
     }
 }
 
-// TODO: cache transaction wire serialization.
 code validate_input::verify_script(const transaction& tx, uint32_t input_index,
     uint32_t forks, bool use_libconsensus)
 {
     if (!use_libconsensus)
         return script::verify(tx, input_index, forks);
 
+    return verify_script(tx, tx.to_data(true, true), input_index, forks,
+        use_libconsensus);
+}
+
+code validate_input::verify_script(const transaction& tx,
+    const data_chunk& tx_data, uint32_t input_index, uint32_t forks,
+    bool use_libconsensus)
+{
+    if (!use_libconsensus)
+        return script::verify(tx, input_index, forks);
+
     BITCOIN_ASSERT(input_index < tx.inputs().size());
     const auto& prevout = tx.inputs()[input_index].previous_output().metadata;
     const auto script_data = prevout.cache.script().to_data(false);
     const auto prevout_value = prevout.cache.value();
 
-    const auto tx_data = tx.to_data(true, true);
-
     // libconsensus
     return convert_result(consensus::verify_script(tx_data.data(),
         tx_data.size(), script_data.data(), script_data.size(), prevout_value,
@@ -182,6 +190,12 @@ code validate_input::verify_script(const transaction& tx,
     return script::verify(tx, input_index, forks);
 }
 
+code validate_input::verify_script(const transaction& tx, const data_chunk&,
+    uint32_t input_index, uint32_t forks, bool use_libconsensus)
+{
+    return verify_script(tx, input_index, forks, use_libconsensus);
+}
+
 #endif
 
 } // namespace blockchain
@@ -38,11 +38,12 @@ using namespace std::placeholders;
 #define NAME "validate_transaction"
 
 validate_transaction::validate_transaction(dispatcher& dispatch,
-    const fast_chain& chain, const settings& settings)
+    const fast_chain& chain, script_cache& cache, const settings& settings)
   : stopped_(true),
     ////retarget_(settings.retarget),
     use_libconsensus_(settings.use_libconsensus),
     dispatch_(dispatch),
+    script_cache_(cache),
     transaction_populator_(dispatch, chain)
 {
 }
@@ -127,18 +128,25 @@ void validate_transaction::connect(transaction_const_ptr tx,
         return;
     }
 
+    // Shared by all inputs of the tx, so compute before fan-out.
+    data_ptr tx_data;
+    if (use_libconsensus_)
+        tx_data = std::make_shared<const data_chunk>(tx->to_data(true, true));
+
     const auto buckets = static_cast<uint32_t>(dispatch);
+    const auto cancel = std::make_shared<cancel_flag>(false);
     const auto join_handler = synchronize(handler, buckets, NAME "_validate");
 
     // If the priority threadpool is shut down when this is called the handler
     // will never be invoked, resulting in a threadpool.join indefinite hang.
     for (uint32_t bucket = 0; bucket < buckets; ++bucket)
         dispatch_.concurrent(&validate_transaction::connect_inputs,
-            this, tx, bucket, buckets, join_handler);
+            this, tx, tx_data, bucket, buckets, cancel, join_handler);
 }
 
 void validate_transaction::connect_inputs(transaction_const_ptr tx,
-    uint32_t bucket, uint32_t buckets, result_handler handler) const
+    data_ptr tx_data, uint32_t bucket, uint32_t buckets,
+    cancel_flag_ptr cancel, result_handler handler) const
 {
     const auto state = tx->metadata.state;
 
@@ -161,6 +169,10 @@ void validate_transaction::connect_inputs(transaction_const_ptr tx,
             break;
         }
 
+        // The join fires on the first error, so other workers just stop.
+        if (*cancel)
+            break;
+
         const auto& prevout = inputs[input_index].previous_output();
 
         if (!prevout.metadata.cache.is_valid())
@@ -169,13 +181,26 @@ void validate_transaction::connect_inputs(transaction_const_ptr tx,
             break;
         }
 
-        if ((ec = validate_input::verify_script(*tx, input_index, forks,
-            use_libconsensus_)))
-        {
+        // The input script was verified with current fork state.
+        if (script_cache_.find(*tx, input_index, forks))
+            continue;
+
+        ec = tx_data ?
+            validate_input::verify_script(*tx, *tx_data, input_index, forks,
+                use_libconsensus_) :
+            validate_input::verify_script(*tx, input_index, forks,
+                use_libconsensus_);
+
+        if (ec)
             break;
-        }
+
+        // Retain the result for block validation of this tx.
+        script_cache_.add(*tx, input_index, forks);
     }
 
+    if (ec)
+        *cancel = true;
+
     handler(ec);
 }
 
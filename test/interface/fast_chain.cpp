@@ -18,6 +18,8 @@
  */
 #include <boost/test/unit_test.hpp>
 
+#include <iterator>
+#include <string>
 #include <bitcoin/blockchain.hpp>
 #include "../utility.hpp"
 
@@ -54,6 +56,16 @@ public:
         return database_;
     }
 
+    bool load_snapshot()
+    {
+        return block_chain::load_snapshot();
+    }
+
+    bool save_snapshot() const
+    {
+        return block_chain::save_snapshot();
+    }
+
     transaction_const_ptr last_pool_transaction() const
     {
         return last_pool_transaction_.load();
@@ -1085,6 +1097,163 @@ BOOST_AUTO_TEST_CASE(block_chain__store__with_cataloging_tx_metadata_not_existed
     // Transaction is cataloged.
 }
 
+// snapshot
+
+// Invert the last (checksum) byte of the snapshot in the given directory.
+static bool corrupt_snapshot(const std::string& directory)
+{
+    const auto path = directory + "/chain_state_snapshot";
+    bc::system::ifstream in(path, std::ifstream::binary);
+    data_chunk data{ std::istreambuf_iterator<char>(in),
+        std::istreambuf_iterator<char>() };
+    in.close();
+
+    if (data.empty())
+        return false;
+
+    data.back() = ~data.back();
+    bc::system::ofstream out(path, std::ofstream::binary);
+    out.write(reinterpret_cast<const char*>(data.data()), data.size());
+    out.close();
+    return static_cast<bool>(out);
+}
+
+BOOST_AUTO_TEST_CASE(block_chain__load_snapshot__not_saved__false)
+{
+    START_BLOCKCHAIN(instance, false, false);
+    BOOST_REQUIRE(!instance.load_snapshot());
+}
+
+BOOST_AUTO_TEST_CASE(block_chain__load_snapshot__saved__true)
+{
+    START_BLOCKCHAIN(instance, false, false);
+    BOOST_REQUIRE(instance.save_snapshot());
+    BOOST_REQUIRE(instance.load_snapshot());
+}
+
+BOOST_AUTO_TEST_CASE(block_chain__load_snapshot__checksum_mismatch__false)
+{
+    START_BLOCKCHAIN(instance, false, false);
+    BOOST_REQUIRE(instance.save_snapshot());
+    BOOST_REQUIRE(corrupt_snapshot(database_settings.directory.string()));
+    BOOST_REQUIRE(!instance.load_snapshot());
+}
+
+BOOST_AUTO_TEST_CASE(block_chain__load_snapshot__top_mismatch__false)
+{
+    START_BLOCKCHAIN(instance, false, false);
+    BOOST_REQUIRE(instance.save_snapshot());
+    BOOST_REQUIRE(test::push_candidates(instance.database()));
+    BOOST_REQUIRE(!instance.load_snapshot());
+}
+
+BOOST_AUTO_TEST_CASE(block_chain__start__snapshot_top_mismatch__recomputed)
+{
+    threadpool pool;
+    database::settings database_settings;
+    database_settings.directory = TEST_NAME;
+    BOOST_REQUIRE(test::create_database(database_settings, false));
+    blockchain::settings blockchain_settings;
+    blockchain_settings.index_payments = false;
+    blockchain_settings.index_headers = true;
+    bc::system::settings bitcoin_settings;
+
+    // The snapshot is written at genesis on close.
+    {
+        block_chain_accessor instance(pool, blockchain_settings,
+            database_settings, bitcoin_settings);
+        BOOST_REQUIRE(instance.start());
+    }
+
+    // The store is extended without the chain, so the snapshot is stale.
+    {
+        database::data_base database(database_settings, false, false);
+        BOOST_REQUIRE(database.open());
+        BOOST_REQUIRE(test::push_candidates(database));
+        BOOST_REQUIRE(database.close());
+    }
+
+    block_chain_accessor instance(pool, blockchain_settings,
+        database_settings, bitcoin_settings);
+    BOOST_REQUIRE(instance.start());
+    BOOST_REQUIRE(!instance.load_snapshot());
+
+    // The header index is rebuilt from the store.
+    hash_digest hash;
+    BOOST_REQUIRE(instance.get_block_hash(hash, 2, true));
+    BOOST_REQUIRE(hash == NEW_BLOCK(2)->hash());
+}
+
+BOOST_AUTO_TEST_CASE(block_chain__start__indexed_snapshot__index_loaded)
+{
+    threadpool pool;
+    database::settings database_settings;
+    database_settings.directory = TEST_NAME;
+    BOOST_REQUIRE(test::create_database(database_settings, false));
+    blockchain::settings blockchain_settings;
+    blockchain_settings.index_payments = false;
+    blockchain_settings.index_headers = true;
+    bc::system::settings bitcoin_settings;
+    const auto block1 = NEW_BLOCK(1);
+    const auto block2 = NEW_BLOCK(2);
+
+    // Headers are indexed by the chain, and the snapshot written on close.
+    {
+        block_chain_accessor instance(pool, blockchain_settings,
+            database_settings, bitcoin_settings);
+        BOOST_REQUIRE(instance.start());
+        const auto header1 = std::make_shared<message::header>(
+            block1->header());
+        const auto header2 = std::make_shared<message::header>(
+            block2->header());
+        header1->metadata.state = instance.promote_state(*header1,
+            instance.top_valid_candidate_state());
+        header2->metadata.state = instance.promote_state(*header2,
+            header1->metadata.state);
+        const auto incoming = std::make_shared<const header_const_ptr_list>(
+            header_const_ptr_list{ header1, header2 });
+        const bc::system::settings mainnet(config::settings::mainnet);
+        const auto& genesis = mainnet.genesis_block;
+        BOOST_REQUIRE_EQUAL(instance.reorganize({ genesis.hash(), 0 },
+            incoming), error::success);
+    }
+
+    block_chain_accessor instance(pool, blockchain_settings,
+        database_settings, bitcoin_settings);
+    BOOST_REQUIRE(instance.start());
+
+    // The snapshot includes header indexes to the store tops.
+    BOOST_REQUIRE(instance.load_snapshot());
+
+    hash_digest hash;
+    BOOST_REQUIRE(instance.get_block_hash(hash, 2, true));
+    BOOST_REQUIRE(hash == block2->hash());
+}
+
+BOOST_AUTO_TEST_CASE(block_chain__load_snapshot__unindexed_snapshot_indexed_chain__false)
+{
+    threadpool pool;
+    database::settings database_settings;
+    database_settings.directory = TEST_NAME;
+    BOOST_REQUIRE(test::create_database(database_settings, false));
+    blockchain::settings blockchain_settings;
+    blockchain_settings.index_payments = false;
+    bc::system::settings bitcoin_settings;
+
+    // The snapshot is written without header indexes on close.
+    {
+        block_chain_accessor instance(pool, blockchain_settings,
+            database_settings, bitcoin_settings);
+        BOOST_REQUIRE(instance.start());
+    }
+
+    blockchain_settings.index_headers = true;
+    block_chain_accessor instance(pool, blockchain_settings,
+        database_settings, bitcoin_settings);
+    BOOST_REQUIRE(instance.start());
+    BOOST_REQUIRE(!instance.load_snapshot());
+}
+
 ////BOOST_AUTO_TEST_CASE(block_chain__push__flushed__expected)
 ////{
 ////    START_BLOCKCHAIN(instance, true);
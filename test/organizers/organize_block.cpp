@@ -0,0 +1,254 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <bitcoin/blockchain.hpp>
+#include "../utility.hpp"
+
+using namespace bc;
+using namespace bc::system;
+using namespace bc::blockchain;
+
+using test::block_chain_accessor;
+
+namespace {
+
+class organize_block_accessor
+  : public organize_block
+{
+public:
+    organize_block_accessor(prioritized_mutex& mutex,
+        dispatcher& priority_dispatch, threadpool& threads, fast_chain& chain,
+        block_pool& pool, const script_cache& cache,
+        const metrics_cache& metrics, const blockchain::settings& settings,
+        const system::settings& bitcoin_settings)
+      : organize_block(mutex, priority_dispatch, threads, chain, pool, cache,
+          metrics, settings, bitcoin_settings)
+    {
+    }
+
+    code accept(block_const_ptr block)
+    {
+        return organize_block::accept(block);
+    }
+
+    void speculate(block_const_ptr parent, size_t height)
+    {
+        organize_block::speculate(parent, height);
+    }
+
+    void settle()
+    {
+        organize_block::settle();
+    }
+
+    void rollback()
+    {
+        organize_block::rollback();
+    }
+
+    bool defer(size_t height, size_t branch_size) const
+    {
+        return organize_block::defer(height, branch_size);
+    }
+};
+
+// Pipelined, with a block pool that holds ten blocks.
+blockchain::settings pipeline_settings()
+{
+    blockchain::settings settings;
+    settings.index_payments = false;
+    settings.block_buffer_limit = 10;
+    settings.pipeline_validation = true;
+    return settings;
+}
+
+} // namespace
+
+// Starts a chain with mainnet blocks 1 and 2 as candidates, and an organizer
+// over a block pool that holds the candidate block 2.
+#define START_ORGANIZER(name, configuration) \
+    START_BLOCKCHAIN(chain, false, false); \
+    BOOST_REQUIRE(test::push_candidates(chain)); \
+    const blockchain::settings chain_settings(configuration); \
+    threadpool priority(4); \
+    dispatcher dispatch(priority, TEST_NAME); \
+    prioritized_mutex mutex; \
+    block_pool blocks(chain, chain_settings); \
+    script_cache scripts(0); \
+    metrics_cache metrics(0); \
+    organize_block_accessor name(mutex, dispatch, pool, chain, blocks, \
+        scripts, metrics, chain_settings, bitcoin_settings); \
+    BOOST_REQUIRE(name.start()); \
+    const auto block1 = NEW_BLOCK(1); \
+    const auto block2 = NEW_BLOCK(2); \
+    blocks.add(block2, 2)
+
+BOOST_FIXTURE_TEST_SUITE(organize_block_tests, test::setup_fixture)
+
+// speculate
+
+BOOST_AUTO_TEST_CASE(organize_block__speculate__not_resident__not_taken)
+{
+    START_ORGANIZER(instance, pipeline_settings());
+
+    // Block 3 is not resident, so nothing is accepted ahead.
+    instance.speculate(block2, 3);
+    instance.settle();
+    BOOST_REQUIRE_EQUAL(blocks.size(), 1u);
+    BOOST_REQUIRE(instance.stop());
+}
+
+// settle
+
+BOOST_AUTO_TEST_CASE(organize_block__settle__failed_speculation__rolled_back)
+{
+    START_ORGANIZER(instance, pipeline_settings());
+    const auto original = chain.top_valid_candidate_state();
+    auto& metadata = block2->header().metadata;
+    metadata.state = original;
+    metadata.validated = false;
+    metadata.error = error::success;
+
+    // The parent has no chain state, so acceptance of block 2 fails.
+    instance.speculate(block1, 2);
+    BOOST_REQUIRE_EQUAL(blocks.size(), 0u);
+    instance.settle();
+
+    // The block is restored and returned to the pool as the candidate.
+    BOOST_REQUIRE(metadata.state == original);
+    BOOST_REQUIRE(!metadata.validated);
+    BOOST_REQUIRE(!metadata.error);
+    BOOST_REQUIRE_EQUAL(blocks.size(), 1u);
+    BOOST_REQUIRE(blocks.take(2) == block2);
+    BOOST_REQUIRE(instance.stop());
+}
+
+// rollback
+
+BOOST_AUTO_TEST_CASE(organize_block__rollback__accepted_not_reached__restored)
+{
+    START_ORGANIZER(instance, pipeline_settings());
+    block1->header().metadata.state = chain.promote_state(block1->header(),
+        chain.top_valid_candidate_state());
+
+    // Block 2 is accepted ahead against the chain state of block 1.
+    instance.speculate(block1, 2);
+    instance.settle();
+    BOOST_REQUIRE_EQUAL(blocks.size(), 0u);
+
+    // Rollback waits on acceptance and restores the unaccepted state.
+    instance.rollback();
+    const auto& metadata = block2->header().metadata;
+    BOOST_REQUIRE(!metadata.state);
+    BOOST_REQUIRE(!metadata.validated);
+    BOOST_REQUIRE_EQUAL(blocks.size(), 1u);
+    BOOST_REQUIRE(blocks.take(2) == block2);
+    BOOST_REQUIRE(instance.stop());
+}
+
+// accept
+
+BOOST_AUTO_TEST_CASE(organize_block__accept__speculated_unchanged__not_repeated)
+{
+    START_ORGANIZER(instance, pipeline_settings());
+    block1->header().metadata.state = chain.promote_state(block1->header(),
+        chain.top_valid_candidate_state());
+
+    instance.speculate(block1, 2);
+    instance.settle();
+    const auto state = block2->header().metadata.state;
+    BOOST_REQUIRE(state);
+
+    // Block 2 spends nothing of block 1, so nothing is repopulated and the
+    // speculative acceptance stands.
+    BOOST_REQUIRE_EQUAL(instance.accept(block2), error::success);
+    BOOST_REQUIRE(block2->header().metadata.state == state);
+
+    // The reached block is not returned to the pool.
+    instance.rollback();
+    BOOST_REQUIRE_EQUAL(blocks.size(), 0u);
+    BOOST_REQUIRE(instance.stop());
+}
+
+BOOST_AUTO_TEST_CASE(organize_block__accept__other_block__speculation_rolled_back)
+{
+    START_ORGANIZER(instance, pipeline_settings());
+    block1->header().metadata.state = chain.promote_state(block1->header(),
+        chain.top_valid_candidate_state());
+
+    instance.speculate(block1, 2);
+    instance.settle();
+    BOOST_REQUIRE_EQUAL(blocks.size(), 0u);
+
+    // Block 1 is accepted instead, so block 2 is returned unaccepted.
+    BOOST_REQUIRE_EQUAL(instance.accept(block1), error::success);
+    BOOST_REQUIRE(!block2->header().metadata.state);
+    BOOST_REQUIRE(!block2->header().metadata.validated);
+    BOOST_REQUIRE_EQUAL(blocks.size(), 1u);
+    BOOST_REQUIRE(instance.stop());
+}
+
+// defer
+
+BOOST_AUTO_TEST_CASE(organize_block__defer__next_covered__true)
+{
+    auto settings = pipeline_settings();
+    settings.checkpoints.emplace_back(null_hash, 20);
+    START_ORGANIZER(instance, settings);
+    BOOST_REQUIRE(instance.defer(5, 1));
+    BOOST_REQUIRE(instance.defer(18, 9));
+    BOOST_REQUIRE(instance.stop());
+}
+
+BOOST_AUTO_TEST_CASE(organize_block__defer__next_not_covered__false)
+{
+    auto settings = pipeline_settings();
+    settings.checkpoints.emplace_back(null_hash, 20);
+    START_ORGANIZER(instance, settings);
+
+    // The batch is confirmed with the last covered block.
+    BOOST_REQUIRE(!instance.defer(20, 1));
+    BOOST_REQUIRE(!instance.defer(42, 1));
+    BOOST_REQUIRE(instance.stop());
+}
+
+BOOST_AUTO_TEST_CASE(organize_block__defer__block_buffer_limit__bounds_batch)
+{
+    auto settings = pipeline_settings();
+    settings.checkpoints.emplace_back(null_hash, 20);
+    START_ORGANIZER(instance, settings);
+
+    // The batch may not extend beyond the blocks that the pool fetches.
+    BOOST_REQUIRE(!instance.defer(15, 10));
+    BOOST_REQUIRE(instance.stop());
+}
+
+BOOST_AUTO_TEST_CASE(organize_block__defer__unbounded_block_buffer__batch_of_100)
+{
+    auto settings = pipeline_settings();
+    settings.block_buffer_limit = 0;
+    settings.checkpoints.emplace_back(null_hash, 1000);
+    START_ORGANIZER(instance, settings);
+    BOOST_REQUIRE(instance.defer(500, 99));
+    BOOST_REQUIRE(!instance.defer(500, 100));
+    BOOST_REQUIRE(instance.stop());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
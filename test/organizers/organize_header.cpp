@@ -0,0 +1,175 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <future>
+#include <bitcoin/blockchain.hpp>
+#include "../utility.hpp"
+
+using namespace bc;
+using namespace bc::system;
+using namespace bc::blockchain;
+
+using test::block_chain_accessor;
+
+// Regtest requires minimal proof of work, so headers are mined in the test.
+static const system::settings regtest(config::settings::regtest);
+
+// Starts a regtest store and chain, and an organizer over a new header pool.
+#define START_ORGANIZER(name, chain_settings) \
+    threadpool pool; \
+    threadpool priority(4); \
+    dispatcher dispatch(priority, TEST_NAME); \
+    database::settings database_settings; \
+    database_settings.directory = TEST_NAME; \
+    BOOST_REQUIRE(test::create_database(database_settings, false, \
+        regtest.genesis_block)); \
+    block_chain_accessor chain(pool, chain_settings, database_settings, \
+        regtest); \
+    BOOST_REQUIRE(chain.start()); \
+    shared_mutex mutex; \
+    header_pool pooled(chain_settings); \
+    organize_header name(mutex, dispatch, pool, chain, pooled, \
+        chain_settings, regtest); \
+    BOOST_REQUIRE(name.start())
+
+// Mine a run of headers on the parent, the salt distinguishes branches.
+static message::header::list mine(const chain::header& parent, size_t count,
+    uint8_t salt)
+{
+    message::header::list run;
+    auto previous = parent;
+    const auto limit = regtest.proof_of_work_limit;
+
+    while (run.size() < count)
+    {
+        for (uint32_t nonce = 0; ; ++nonce)
+        {
+            const message::header header{ 4, previous.hash(),
+                hash_digest{ { salt } }, previous.timestamp() + 600, limit,
+                nonce };
+
+            if (!header.check(regtest.timestamp_limit_seconds, limit, false))
+            {
+                run.push_back(header);
+                previous = header;
+                break;
+            }
+        }
+    }
+
+    return run;
+}
+
+static headers_const_ptr to_headers(const message::header::list& run,
+    size_t count)
+{
+    return std::make_shared<const message::headers>(
+        message::header::list(run.begin(), run.begin() + count));
+}
+
+static code organize(organize_header& organizer, headers_const_ptr headers)
+{
+    std::promise<code> promise;
+    const auto handler = [&promise](const code& ec)
+    {
+        promise.set_value(ec);
+    };
+
+    organizer.organize(headers, handler);
+    return promise.get_future().get();
+}
+
+BOOST_FIXTURE_TEST_SUITE(organize_header_tests, test::setup_fixture)
+
+// organize headers
+
+BOOST_AUTO_TEST_CASE(organize_header__organize_headers__leading_duplicates__skipped)
+{
+    blockchain::settings settings(config::settings::regtest);
+    settings.index_payments = false;
+    START_ORGANIZER(instance, settings);
+    const auto run = mine(regtest.genesis_block.header(), 3, 1);
+
+    BOOST_REQUIRE_EQUAL(organize(instance, to_headers(run, 2)), error::success);
+
+    // The first two headers are stored, so only the third is organized.
+    BOOST_REQUIRE_EQUAL(organize(instance, to_headers(run, 3)), error::success);
+
+    config::checkpoint top;
+    BOOST_REQUIRE(chain.get_top(top, true));
+    BOOST_REQUIRE_EQUAL(top.height(), 3u);
+    BOOST_REQUIRE(top.hash() == run[2].hash());
+    BOOST_REQUIRE_EQUAL(pooled.size(), 0u);
+
+    // All headers are stored.
+    BOOST_REQUIRE_EQUAL(organize(instance, to_headers(run, 3)),
+        error::duplicate_block);
+}
+
+BOOST_AUTO_TEST_CASE(organize_header__organize_headers__invalid_second__prefix_committed)
+{
+    const auto run = mine(regtest.genesis_block.header(), 3, 1);
+
+    // The second header conflicts with a checkpoint, so fails acceptance.
+    blockchain::settings settings(config::settings::regtest);
+    settings.index_payments = false;
+    settings.checkpoints.emplace_back(hash_digest{ { 42 } }, 2);
+    START_ORGANIZER(instance, settings);
+
+    BOOST_REQUIRE_EQUAL(organize(instance, to_headers(run, 3)),
+        error::checkpoints_failed);
+
+    config::checkpoint top;
+    BOOST_REQUIRE(chain.get_top(top, true));
+    BOOST_REQUIRE_EQUAL(top.height(), 1u);
+    BOOST_REQUIRE(top.hash() == run[0].hash());
+    BOOST_REQUIRE_EQUAL(pooled.size(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(organize_header__organize_headers__insufficient_work__unpooled_suffix_pooled)
+{
+    blockchain::settings settings(config::settings::regtest);
+    settings.index_payments = false;
+    START_ORGANIZER(instance, settings);
+    const auto& genesis = regtest.genesis_block.header();
+    const auto stronger = mine(genesis, 3, 1);
+    const auto weaker = mine(genesis, 3, 2);
+
+    BOOST_REQUIRE_EQUAL(organize(instance, to_headers(stronger, 3)),
+        error::success);
+
+    // Two headers of less work than the candidate chain are pooled.
+    BOOST_REQUIRE_EQUAL(organize(instance, to_headers(weaker, 2)),
+        error::insufficient_work);
+    BOOST_REQUIRE_EQUAL(pooled.size(), 2u);
+
+    // Equal work is insufficient, and only the unpooled header is pooled.
+    BOOST_REQUIRE_EQUAL(organize(instance, to_headers(weaker, 3)),
+        error::insufficient_work);
+    BOOST_REQUIRE_EQUAL(pooled.size(), 3u);
+    BOOST_REQUIRE(pooled.exists(
+        std::make_shared<const message::header>(weaker[2])));
+
+    config::checkpoint top;
+    BOOST_REQUIRE(chain.get_top(top, true));
+    BOOST_REQUIRE(top.hash() == stronger[2].hash());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
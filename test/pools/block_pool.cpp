@@ -19,11 +19,64 @@
 #include <boost/test/unit_test.hpp>
 
 #include <bitcoin/blockchain.hpp>
+#include "../utility.hpp"
 
-BOOST_AUTO_TEST_SUITE(block_pool_tests)
+using namespace bc;
+using namespace bc::system;
+using namespace bc::blockchain;
+
+using test::block_chain_accessor;
+
+BOOST_FIXTURE_TEST_SUITE(block_pool_tests, test::setup_fixture)
 
 BOOST_AUTO_TEST_CASE(block_pool__construct__todo__success)
 {
 }
 
+// take
+
+BOOST_AUTO_TEST_CASE(block_pool__take__disabled__null)
+{
+    START_BLOCKCHAIN(chain, false, false);
+    blockchain::settings settings;
+    settings.block_buffer_limit = 0;
+    block_pool instance(chain, settings);
+    BOOST_REQUIRE(instance.start());
+
+    instance.add(NEW_BLOCK(1), 1);
+    BOOST_REQUIRE(!instance.take(1));
+    BOOST_REQUIRE(instance.stop());
+}
+
+BOOST_AUTO_TEST_CASE(block_pool__take__resident__removed)
+{
+    START_BLOCKCHAIN(chain, false, false);
+    blockchain::settings settings;
+    settings.block_buffer_limit = 10;
+    block_pool instance(chain, settings);
+    BOOST_REQUIRE(instance.start());
+
+    const auto block1 = NEW_BLOCK(1);
+    instance.add(block1, 1);
+    BOOST_REQUIRE_EQUAL(instance.size(), 1u);
+    BOOST_REQUIRE(instance.take(1) == block1);
+    BOOST_REQUIRE_EQUAL(instance.size(), 0u);
+    BOOST_REQUIRE(!instance.take(1));
+    BOOST_REQUIRE(instance.stop());
+}
+
+BOOST_AUTO_TEST_CASE(block_pool__take__not_resident__null_without_read)
+{
+    START_BLOCKCHAIN(chain, false, false);
+    blockchain::settings settings;
+    settings.block_buffer_limit = 10;
+    block_pool instance(chain, settings);
+    BOOST_REQUIRE(instance.start());
+
+    // The block is neither cached nor read from the store.
+    BOOST_REQUIRE(!instance.take(2));
+    BOOST_REQUIRE_EQUAL(instance.size(), 0u);
+    BOOST_REQUIRE(instance.stop());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -232,6 +232,64 @@ BOOST_AUTO_TEST_CASE(header_branch__push_front__two_unlinked__link_failure)
     BOOST_REQUIRE((*instance.headers())[0] == header1);
 }
 
+// extend
+
+BOOST_AUTO_TEST_CASE(header_branch__extend__two_linked__success)
+{
+    header_branch_fixture instance;
+    DECLARE_HEADER(header, 0);
+    DECLARE_HEADER(header, 1);
+
+    // Link the headers.
+    header1->set_previous_block_hash(header0->hash());
+
+    BOOST_REQUIRE(instance.extend(header0));
+    BOOST_REQUIRE(instance.extend(header1));
+    BOOST_REQUIRE_EQUAL(instance.size(), 2u);
+    BOOST_REQUIRE((*instance.headers())[0] == header0);
+    BOOST_REQUIRE(instance.top() == header1);
+}
+
+BOOST_AUTO_TEST_CASE(header_branch__extend__two_unlinked__link_failure)
+{
+    header_branch_fixture instance;
+    DECLARE_HEADER(header, 0);
+    DECLARE_HEADER(header, 1);
+
+    // Ensure the headers are not linked.
+    header1->set_previous_block_hash(null_hash);
+
+    BOOST_REQUIRE(instance.extend(header0));
+    BOOST_REQUIRE(!instance.extend(header1));
+    BOOST_REQUIRE_EQUAL(instance.size(), 1u);
+    BOOST_REQUIRE(instance.top() == header0);
+}
+
+// pop
+
+BOOST_AUTO_TEST_CASE(header_branch__pop__default__empty)
+{
+    header_branch instance;
+    instance.pop();
+    BOOST_REQUIRE(instance.empty());
+}
+
+BOOST_AUTO_TEST_CASE(header_branch__pop__two_headers__top_removed)
+{
+    header_branch_fixture instance;
+    DECLARE_HEADER(header, 0);
+    DECLARE_HEADER(header, 1);
+
+    // Link the headers.
+    header1->set_previous_block_hash(header0->hash());
+
+    BOOST_REQUIRE(instance.push(header1));
+    BOOST_REQUIRE(instance.push(header0));
+    instance.pop();
+    BOOST_REQUIRE_EQUAL(instance.size(), 1u);
+    BOOST_REQUIRE(instance.top() == header0);
+}
+
 // top
 
 BOOST_AUTO_TEST_CASE(header_branch__top__default__nullptr)
@@ -40,6 +40,18 @@ BOOST_AUTO_TEST_CASE(header_entry__construct1__default_header__expected)
     BOOST_REQUIRE(instance.hash() == default_header_hash);
 }
 
+// construct3/work
+
+BOOST_AUTO_TEST_CASE(header_entry__construct3__work_sequence__round_trips)
+{
+    const auto header = std::make_shared<const message::header>();
+    const uint256_t work{ 42 };
+    header_entry instance(header, 0, work, 7);
+    BOOST_REQUIRE(instance.header() == header);
+    BOOST_REQUIRE(instance.work() == work);
+    BOOST_REQUIRE_EQUAL(instance.sequence(), 7u);
+}
+
 // construct2/hash
 
 BOOST_AUTO_TEST_CASE(header_entry__construct2__default_header_hash__round_trips)
@@ -93,6 +105,24 @@ BOOST_AUTO_TEST_CASE(header_entry__add_child__two__expected_order)
     BOOST_REQUIRE(instance.children()[1] == child2->hash());
 }
 
+// remove_child
+
+BOOST_AUTO_TEST_CASE(header_entry__remove_child__two__remaining)
+{
+    header_entry instance(null_hash);
+
+    const auto child1 = std::make_shared<const message::header>();
+    instance.add_child(child1);
+
+    const auto child2 = std::make_shared<message::header>();
+    child2->set_previous_block_hash(hash42);
+    instance.add_child(child2);
+
+    instance.remove_child(child1->hash());
+    BOOST_REQUIRE_EQUAL(instance.children().size(), 1u);
+    BOOST_REQUIRE(instance.children()[0] == child2->hash());
+}
+
 // equality
 
 BOOST_AUTO_TEST_CASE(header_entry__equality__same__true)
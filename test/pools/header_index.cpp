@@ -0,0 +1,192 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <bitcoin/blockchain.hpp>
+
+using namespace bc;
+using namespace bc::blockchain;
+using namespace bc::system;
+using namespace bc::system::chain;
+
+BOOST_AUTO_TEST_SUITE(header_index_tests)
+
+static const uint32_t bits = 0x207fffff;
+
+// A header with version and timestamp distinguished by height.
+static header make_header(uint32_t height)
+{
+    return { height, null_hash, null_hash, height + 1u, bits, 0 };
+}
+
+static void push_range(header_index& instance, uint32_t first,
+    uint32_t last)
+{
+    for (auto height = first; height <= last; ++height)
+        instance.push(make_header(height), height);
+}
+
+BOOST_AUTO_TEST_CASE(header_index__get__empty__false)
+{
+    const header_index instance;
+    hash_digest hash;
+    BOOST_REQUIRE(!instance.get_block_hash(hash, 0));
+    BOOST_REQUIRE_EQUAL(instance.size(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(header_index__push__contiguous__fields)
+{
+    header_index instance;
+    push_range(instance, 0, 3);
+    BOOST_REQUIRE_EQUAL(instance.size(), 4u);
+
+    uint32_t version;
+    uint32_t timestamp;
+    uint32_t value;
+    hash_digest hash;
+    BOOST_REQUIRE(instance.get_version(version, 2));
+    BOOST_REQUIRE(instance.get_timestamp(timestamp, 2));
+    BOOST_REQUIRE(instance.get_bits(value, 2));
+    BOOST_REQUIRE(instance.get_block_hash(hash, 2));
+    BOOST_REQUIRE_EQUAL(version, 2u);
+    BOOST_REQUIRE_EQUAL(timestamp, 3u);
+    BOOST_REQUIRE_EQUAL(value, bits);
+    BOOST_REQUIRE(hash == make_header(2).hash());
+    BOOST_REQUIRE(!instance.get_version(version, 4));
+}
+
+BOOST_AUTO_TEST_CASE(header_index__push__gap__ignored)
+{
+    header_index instance;
+    push_range(instance, 0, 1);
+    instance.push(make_header(3), 3);
+    BOOST_REQUIRE_EQUAL(instance.size(), 2u);
+}
+
+BOOST_AUTO_TEST_CASE(header_index__pop__fork__truncated)
+{
+    header_index instance;
+    push_range(instance, 0, 4);
+    instance.pop(2);
+    BOOST_REQUIRE_EQUAL(instance.size(), 3u);
+
+    uint32_t version;
+    instance.push(make_header(13), 3);
+    BOOST_REQUIRE(instance.get_version(version, 3));
+    BOOST_REQUIRE_EQUAL(version, 13u);
+}
+
+BOOST_AUTO_TEST_CASE(header_index__get_work__above_height__summed)
+{
+    header_index instance;
+    push_range(instance, 0, 4);
+
+    uint256_t work;
+    BOOST_REQUIRE(instance.get_work(work, 0, 1, 4));
+    BOOST_REQUIRE(work == 3 * header::proof(bits));
+}
+
+BOOST_AUTO_TEST_CASE(header_index__get_work__overcome__early_exit)
+{
+    header_index instance;
+    push_range(instance, 0, 4);
+
+    uint256_t work;
+    BOOST_REQUIRE(instance.get_work(work, 1, 0, 4));
+    BOOST_REQUIRE(work == header::proof(bits));
+}
+
+BOOST_AUTO_TEST_CASE(header_index__get_work__overcome_within__partial_sum)
+{
+    header_index instance;
+    push_range(instance, 0, 4);
+    const auto proof = header::proof(bits);
+
+    uint256_t work;
+    BOOST_REQUIRE(instance.get_work(work, 2 * proof + 1, 0, 4));
+    BOOST_REQUIRE(work == 3 * proof);
+}
+
+BOOST_AUTO_TEST_CASE(header_index__get_work__at_top__zero)
+{
+    header_index instance;
+    push_range(instance, 0, 4);
+
+    uint256_t work;
+    BOOST_REQUIRE(instance.get_work(work, 0, 4, 4));
+    BOOST_REQUIRE(work == 0);
+}
+
+BOOST_AUTO_TEST_CASE(header_index__get_work__top_mismatch__false)
+{
+    header_index instance;
+    push_range(instance, 0, 4);
+
+    uint256_t work;
+    BOOST_REQUIRE(!instance.get_work(work, 0, 0, 5));
+}
+
+BOOST_AUTO_TEST_CASE(header_index__from_data__to_data__round_trip)
+{
+    header_index instance;
+    push_range(instance, 0, 4);
+
+    data_chunk data;
+    data_sink ostream(data);
+    ostream_writer sink(ostream);
+    instance.to_data(sink);
+    ostream.flush();
+
+    header_index copy;
+    data_source istream(data);
+    istream_reader source(istream);
+    BOOST_REQUIRE(copy.from_data(source));
+    BOOST_REQUIRE_EQUAL(copy.size(), 5u);
+
+    uint32_t version;
+    BOOST_REQUIRE(copy.get_version(version, 4));
+    BOOST_REQUIRE_EQUAL(version, 4u);
+
+    // Work is recomputed from bits.
+    uint256_t work;
+    BOOST_REQUIRE(copy.get_work(work, 0, 1, 4));
+    BOOST_REQUIRE(work == 3 * header::proof(bits));
+}
+
+BOOST_AUTO_TEST_CASE(header_index__from_data__truncated__false_empty)
+{
+    header_index instance;
+    push_range(instance, 0, 4);
+
+    data_chunk data;
+    data_sink ostream(data);
+    ostream_writer sink(ostream);
+    instance.to_data(sink);
+    ostream.flush();
+    data.pop_back();
+
+    header_index copy;
+    push_range(copy, 0, 1);
+    data_source istream(data);
+    istream_reader source(istream);
+    BOOST_REQUIRE(!copy.from_data(source));
+    BOOST_REQUIRE_EQUAL(copy.size(), 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -20,9 +20,11 @@
 
 #include <utility>
 #include <bitcoin/blockchain.hpp>
+#include "utilities/utilities.hpp"
 
 using namespace bc;
 using namespace bc::blockchain;
+using namespace bc::blockchain::test::pools;
 using namespace bc::system;
 
 BOOST_AUTO_TEST_SUITE(header_pool_tests)
@@ -68,6 +70,15 @@ header_const_ptr make_header(uint32_t id)
     return make_header(id, null_hash);
 }
 
+header_const_ptr make_work_header(uint32_t id, const hash_digest& parent)
+{
+    static const uint32_t bits = 0x1d00ffff;
+    return std::make_shared<const message::header>(chain::header
+    {
+        id, parent, null_hash, 0, bits, 0
+    });
+}
+
 // construct
 
 BOOST_AUTO_TEST_CASE(header_pool__construct__zero_depth__sets__maximum_value)
@@ -166,6 +177,155 @@ BOOST_AUTO_TEST_CASE(header_pool__add1__two_distinct_hash__two)
     BOOST_REQUIRE(entry2->second.header() == header2);
 }
 
+BOOST_AUTO_TEST_CASE(header_pool__add1__child__parent_state_cleared)
+{
+    blockchain::settings settings;
+    settings.reorganization_limit = 0;
+    header_pool_fixture instance(settings);
+    const auto header1 = make_header(1);
+    const auto header2 = make_header(2, header1);
+    const auto state = std::make_shared<chain::chain_state>(chain::chain_state
+    {
+        utilities::get_chain_data(), {}, 0, 0, system::settings()
+    });
+
+    header1->metadata.state = state;
+    header2->metadata.state = state;
+    instance.add(header1, 42);
+    BOOST_REQUIRE(header1->metadata.state);
+
+    // Only the branch tip retains chain state.
+    instance.add(header2, 43);
+    BOOST_REQUIRE(!header1->metadata.state);
+    BOOST_REQUIRE(header2->metadata.state);
+}
+
+BOOST_AUTO_TEST_CASE(header_pool__add1__unbounded__no_evictions)
+{
+    blockchain::settings settings;
+    settings.header_pool_bytes = 0;
+    header_pool_fixture instance(settings);
+    instance.add(make_header(1), 42);
+    instance.add(make_header(2), 43);
+    BOOST_REQUIRE_EQUAL(instance.size(), 2u);
+    BOOST_REQUIRE_EQUAL(instance.evictions(), 0u);
+    BOOST_REQUIRE(instance.bytes() != 0u);
+}
+
+BOOST_AUTO_TEST_CASE(header_pool__add1__over_budget__oldest_root_evicted)
+{
+    blockchain::settings settings;
+    header_pool_fixture sizer(settings);
+    sizer.add(make_header(0), 42);
+
+    // Budget for two headers.
+    settings.header_pool_bytes = 2u * sizer.bytes();
+    header_pool_fixture instance(settings);
+    const auto header1 = make_header(1);
+    const auto header2 = make_header(2);
+    const auto header3 = make_header(3);
+
+    instance.add(header1, 42);
+    instance.add(header2, 43);
+    BOOST_REQUIRE_EQUAL(instance.evictions(), 0u);
+
+    // The roots have equal work, so the first inserted is evicted.
+    instance.add(header3, 44);
+    BOOST_REQUIRE_EQUAL(instance.size(), 2u);
+    BOOST_REQUIRE_EQUAL(instance.evictions(), 1u);
+    BOOST_REQUIRE(!instance.exists(header1));
+    BOOST_REQUIRE(instance.exists(header2));
+    BOOST_REQUIRE(instance.exists(header3));
+}
+
+BOOST_AUTO_TEST_CASE(header_pool__add1__over_budget__least_work_tip_evicted)
+{
+    blockchain::settings settings;
+    header_pool_fixture sizer(settings);
+    sizer.add(make_header(0), 42);
+
+    // Budget for three headers.
+    settings.header_pool_bytes = 3u * sizer.bytes();
+    header_pool_fixture instance(settings);
+    const auto header1 = make_work_header(1, null_hash);
+    const auto header2 = make_work_header(2, header1->hash());
+    const auto header3 = make_work_header(3, header2->hash());
+    const auto header4 = make_work_header(4, null_hash);
+
+    instance.add(header1, 42);
+    instance.add(header2, 43);
+    instance.add(header3, 44);
+    BOOST_REQUIRE_EQUAL(instance.evictions(), 0u);
+
+    // The new root has less work than the older branch, so it is evicted.
+    instance.add(header4, 42);
+    BOOST_REQUIRE_EQUAL(instance.size(), 3u);
+    BOOST_REQUIRE_EQUAL(instance.evictions(), 1u);
+    BOOST_REQUIRE(!instance.exists(header4));
+    BOOST_REQUIRE(instance.exists(header3));
+}
+
+BOOST_AUTO_TEST_CASE(header_pool__add1__over_budget__weaker_higher_root_evicted)
+{
+    blockchain::settings settings;
+    header_pool_fixture sizer(settings);
+    const auto header1 = make_work_header(1, null_hash);
+    const auto header2 = make_work_header(2, header1->hash());
+    const auto header3 = make_header(3);
+    const auto header4 = make_header(4);
+    sizer.add(header1, 42);
+    sizer.add(header2, 43);
+    sizer.add(header3, 50);
+
+    // Budget for a branch of two headers and a root.
+    settings.header_pool_bytes = sizer.bytes();
+    header_pool_fixture instance(settings);
+    instance.add(header1, 42);
+    instance.add(header2, 43);
+    instance.add(header3, 50);
+    BOOST_REQUIRE_EQUAL(instance.evictions(), 0u);
+
+    // The lower branch has more work, so the oldest of the weaker (higher)
+    // roots is evicted.
+    instance.add(header4, 51);
+    BOOST_REQUIRE_EQUAL(instance.size(), 3u);
+    BOOST_REQUIRE_EQUAL(instance.evictions(), 1u);
+    BOOST_REQUIRE(!instance.exists(header3));
+    BOOST_REQUIRE(instance.exists(header1));
+    BOOST_REQUIRE(instance.exists(header2));
+    BOOST_REQUIRE(instance.exists(header4));
+}
+
+BOOST_AUTO_TEST_CASE(header_pool__add1__over_budget__tip_state_counted)
+{
+    blockchain::settings settings;
+    header_pool_fixture sizer(settings);
+    sizer.add(make_header(0), 42);
+
+    // Budget for three single header branches.
+    settings.header_pool_bytes = 3u * sizer.bytes();
+    header_pool_fixture instance(settings);
+    const auto header1 = make_header(1);
+    const auto header2 = make_header(2, header1);
+    const auto header3 = make_header(3, header2);
+    const auto header4 = make_header(4, header3);
+
+    // A linear branch retains chain state only at its tip, so it fits.
+    instance.add(header1, 42);
+    instance.add(header2, 43);
+    instance.add(header3, 44);
+    instance.add(header4, 45);
+    BOOST_REQUIRE_EQUAL(instance.size(), 4u);
+    BOOST_REQUIRE_EQUAL(instance.evictions(), 0u);
+
+    // Each fork is a tip that retains chain state, so forks exceed it.
+    instance.add(make_header(5, header1), 43);
+    BOOST_REQUIRE_EQUAL(instance.evictions(), 0u);
+    instance.add(make_header(6, header1), 43);
+    BOOST_REQUIRE(instance.evictions() != 0u);
+    BOOST_REQUIRE(instance.bytes() <= settings.header_pool_bytes);
+}
+
 // add2
 
 BOOST_AUTO_TEST_CASE(header_pool__add2__empty__empty)
@@ -344,6 +504,34 @@ BOOST_AUTO_TEST_CASE(header_pool__prune__one_expired__one_deleted)
     BOOST_REQUIRE_EQUAL(instance.size(), 4u);
 }
 
+BOOST_AUTO_TEST_CASE(header_pool__prune__unordered_roots__expired_roots_deleted)
+{
+    blockchain::settings settings;
+    settings.reorganization_limit = 10;
+    header_pool_fixture instance(settings);
+    const auto header1 = make_header(1);
+    const auto header2 = make_header(2);
+    const auto header3 = make_header(3);
+    const auto header4 = make_header(4);
+    const auto header5 = make_header(5);
+
+    instance.add(header1, 46);
+    instance.add(header2, 42);
+    instance.add(header3, 45);
+    instance.add(header4, 43);
+    instance.add(header5, 44);
+    BOOST_REQUIRE_EQUAL(instance.size(), 5u);
+
+    // Any height less than 44 (54 - 10) should be pruned.
+    instance.prune(54);
+    BOOST_REQUIRE_EQUAL(instance.size(), 3u);
+    BOOST_REQUIRE(!instance.exists(header2));
+    BOOST_REQUIRE(!instance.exists(header4));
+    BOOST_REQUIRE(instance.exists(header1));
+    BOOST_REQUIRE(instance.exists(header3));
+    BOOST_REQUIRE(instance.exists(header5));
+}
+
 BOOST_AUTO_TEST_CASE(header_pool__prune__whole_header_branch_expired__whole_header_branch_deleted)
 {
     blockchain::settings settings;
@@ -0,0 +1,175 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <bitcoin/blockchain.hpp>
+
+using namespace bc;
+using namespace bc::blockchain;
+using namespace bc::system;
+using namespace bc::system::chain;
+
+BOOST_AUTO_TEST_SUITE(header_window_tests)
+
+// A header with fields distinguished by height.
+static header make_header(uint32_t height)
+{
+    return { height, null_hash, null_hash, height + 1u, height + 2u, 0 };
+}
+
+static void push_range(header_window& instance, uint32_t first,
+    uint32_t last)
+{
+    for (auto height = first; height <= last; ++height)
+        instance.push(make_header(height), height);
+}
+
+BOOST_AUTO_TEST_CASE(header_window__get__empty__false)
+{
+    const header_window instance(10);
+    uint32_t bits;
+    BOOST_REQUIRE(!instance.get_bits(bits, 0));
+    BOOST_REQUIRE_EQUAL(instance.size(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(header_window__push__zero_capacity__disabled)
+{
+    header_window instance(0);
+    instance.push(make_header(1), 1);
+    hash_digest hash;
+    BOOST_REQUIRE(!instance.get_block_hash(hash, 1));
+    BOOST_REQUIRE_EQUAL(instance.size(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(header_window__push__contiguous__fields)
+{
+    header_window instance(10);
+    push_range(instance, 5, 7);
+    BOOST_REQUIRE_EQUAL(instance.size(), 3u);
+
+    uint32_t version;
+    uint32_t timestamp;
+    uint32_t bits;
+    hash_digest hash;
+    BOOST_REQUIRE(instance.get_version(version, 6));
+    BOOST_REQUIRE(instance.get_timestamp(timestamp, 6));
+    BOOST_REQUIRE(instance.get_bits(bits, 6));
+    BOOST_REQUIRE(instance.get_block_hash(hash, 6));
+    BOOST_REQUIRE_EQUAL(version, 6u);
+    BOOST_REQUIRE_EQUAL(timestamp, 7u);
+    BOOST_REQUIRE_EQUAL(bits, 8u);
+    BOOST_REQUIRE(hash == make_header(6).hash());
+    BOOST_REQUIRE(!instance.get_bits(bits, 4));
+    BOOST_REQUIRE(!instance.get_bits(bits, 8));
+}
+
+BOOST_AUTO_TEST_CASE(header_window__push__over_capacity__oldest_dropped)
+{
+    header_window instance(3);
+    push_range(instance, 0, 4);
+    BOOST_REQUIRE_EQUAL(instance.size(), 3u);
+
+    uint32_t version;
+    BOOST_REQUIRE(!instance.get_version(version, 1));
+    BOOST_REQUIRE(instance.get_version(version, 2));
+    BOOST_REQUIRE(instance.get_version(version, 4));
+    BOOST_REQUIRE_EQUAL(version, 4u);
+}
+
+BOOST_AUTO_TEST_CASE(header_window__push__gap__reset)
+{
+    header_window instance(10);
+    push_range(instance, 0, 4);
+    instance.push(make_header(7), 7);
+    BOOST_REQUIRE_EQUAL(instance.size(), 1u);
+
+    uint32_t version;
+    BOOST_REQUIRE(!instance.get_version(version, 4));
+    BOOST_REQUIRE(instance.get_version(version, 7));
+}
+
+BOOST_AUTO_TEST_CASE(header_window__pop__fork__truncated)
+{
+    header_window instance(10);
+    push_range(instance, 0, 4);
+    instance.pop(2);
+    BOOST_REQUIRE_EQUAL(instance.size(), 3u);
+
+    uint32_t version;
+    BOOST_REQUIRE(!instance.get_version(version, 3));
+    BOOST_REQUIRE(instance.get_version(version, 2));
+
+    // Replacement headers extend the truncated window.
+    instance.push(make_header(13), 3);
+    BOOST_REQUIRE(instance.get_version(version, 3));
+    BOOST_REQUIRE_EQUAL(version, 13u);
+    BOOST_REQUIRE_EQUAL(instance.size(), 4u);
+}
+
+BOOST_AUTO_TEST_CASE(header_window__pop__below_window__empty)
+{
+    header_window instance(3);
+    push_range(instance, 0, 9);
+    instance.pop(5);
+    BOOST_REQUIRE_EQUAL(instance.size(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(header_window__from_data__to_data__round_trip)
+{
+    header_window instance(3);
+    push_range(instance, 0, 4);
+
+    data_chunk data;
+    data_sink ostream(data);
+    ostream_writer sink(ostream);
+    instance.to_data(sink);
+    ostream.flush();
+
+    header_window copy(3);
+    data_source istream(data);
+    istream_reader source(istream);
+    BOOST_REQUIRE(copy.from_data(source));
+    BOOST_REQUIRE_EQUAL(copy.size(), 3u);
+
+    uint32_t version;
+    BOOST_REQUIRE(!copy.get_version(version, 1));
+    BOOST_REQUIRE(copy.get_version(version, 4));
+    BOOST_REQUIRE_EQUAL(version, 4u);
+}
+
+BOOST_AUTO_TEST_CASE(header_window__from_data__capacity_mismatch__false_empty)
+{
+    header_window instance(3);
+    push_range(instance, 0, 4);
+
+    data_chunk data;
+    data_sink ostream(data);
+    ostream_writer sink(ostream);
+    instance.to_data(sink);
+    ostream.flush();
+
+    header_window copy(4);
+    push_range(copy, 0, 1);
+    data_source istream(data);
+    istream_reader source(istream);
+    BOOST_REQUIRE(!copy.from_data(source));
+    BOOST_REQUIRE_EQUAL(copy.size(), 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
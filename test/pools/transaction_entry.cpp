@@ -87,7 +87,28 @@ BOOST_AUTO_TEST_CASE(transaction_entry__construct1__default_tx__expected_values)
     BOOST_REQUIRE(instance.children().empty());
 }
 
-// construct2/hash
+// construct2/metrics
+
+BOOST_AUTO_TEST_CASE(transaction_entry__construct2__cached_metrics__expected_values)
+{
+    const auto tx = make_tx();
+    metrics_cache cache(10);
+    const auto metrics = cache.add(*tx, true, true);
+    const transaction_entry instance(tx, metrics);
+    BOOST_REQUIRE_EQUAL(cache.size(), 1u);
+    BOOST_REQUIRE_EQUAL(instance.sigops(), metrics.sigops);
+    BOOST_REQUIRE_EQUAL(instance.size(), metrics.size);
+    BOOST_REQUIRE(instance.hash() == default_tx_hash);
+}
+
+BOOST_AUTO_TEST_CASE(transaction_entry__construct2__metrics__not_recomputed)
+{
+    const transaction_entry instance(make_tx(), { 42, 7 });
+    BOOST_REQUIRE_EQUAL(instance.sigops(), 7u);
+    BOOST_REQUIRE_EQUAL(instance.size(), 42u);
+}
+
+// construct3/hash
 
 BOOST_AUTO_TEST_CASE(transaction_entry__construct1__default_block_hash__expected_values)
 {
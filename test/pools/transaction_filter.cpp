@@ -0,0 +1,164 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <bitcoin/blockchain.hpp>
+
+using namespace bc;
+using namespace bc::blockchain;
+using namespace bc::system;
+
+BOOST_AUTO_TEST_SUITE(transaction_filter_tests)
+
+// A distinct, well distributed hash for each value.
+static hash_digest make_hash(uint32_t value)
+{
+    return sha256_hash(to_little_endian(value));
+}
+
+BOOST_AUTO_TEST_CASE(transaction_filter__construct__zero_limit__saturated)
+{
+    const transaction_filter instance(0);
+    BOOST_REQUIRE(instance.saturated());
+    BOOST_REQUIRE_EQUAL(instance.bytes(), 0u);
+    BOOST_REQUIRE(instance.contains(make_hash(1)));
+    BOOST_REQUIRE_EQUAL(instance.false_positive_rate(), 1.0);
+}
+
+BOOST_AUTO_TEST_CASE(transaction_filter__construct__limit__power_of_two_buckets)
+{
+    const transaction_filter instance(1000);
+    BOOST_REQUIRE(!instance.saturated());
+    BOOST_REQUIRE_EQUAL(instance.bytes(), 64u * 8u);
+    BOOST_REQUIRE_EQUAL(instance.false_positive_rate(), 0.0);
+}
+
+BOOST_AUTO_TEST_CASE(transaction_filter__contains__empty__false_negative)
+{
+    const transaction_filter instance(1000);
+    BOOST_REQUIRE(!instance.contains(make_hash(1)));
+    BOOST_REQUIRE_EQUAL(instance.queries(), 1u);
+    BOOST_REQUIRE_EQUAL(instance.negatives(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(transaction_filter__add__hashes__all_contained)
+{
+    transaction_filter instance(1024);
+
+    for (uint32_t value = 0; value < 200; ++value)
+        instance.add(make_hash(value));
+
+    BOOST_REQUIRE(!instance.saturated());
+
+    for (uint32_t value = 0; value < 200; ++value)
+        BOOST_REQUIRE(instance.contains(make_hash(value)));
+
+    BOOST_REQUIRE_EQUAL(instance.negatives(), 0u);
+    BOOST_REQUIRE(instance.false_positive_rate() > 0.0);
+}
+
+BOOST_AUTO_TEST_CASE(transaction_filter__add__duplicate__not_counted)
+{
+    transaction_filter instance(1000);
+    instance.add(make_hash(1));
+    instance.add(make_hash(1));
+    BOOST_REQUIRE_EQUAL(instance.size(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(transaction_filter__add__over_capacity__saturated)
+{
+    transaction_filter instance(64);
+
+    for (uint32_t value = 0; value < 100; ++value)
+        instance.add(make_hash(value));
+
+    BOOST_REQUIRE(instance.saturated());
+    BOOST_REQUIRE(instance.contains(make_hash(1000)));
+}
+
+BOOST_AUTO_TEST_CASE(transaction_filter__clear__saturated__empty)
+{
+    transaction_filter instance(64);
+
+    for (uint32_t value = 0; value < 100; ++value)
+        instance.add(make_hash(value));
+
+    instance.clear();
+    BOOST_REQUIRE(!instance.saturated());
+    BOOST_REQUIRE_EQUAL(instance.size(), 0u);
+    BOOST_REQUIRE(!instance.contains(make_hash(1)));
+}
+
+BOOST_AUTO_TEST_CASE(transaction_filter__saturate__empty__always_contains)
+{
+    transaction_filter instance(1000);
+    instance.saturate();
+    BOOST_REQUIRE(instance.saturated());
+    BOOST_REQUIRE(instance.contains(make_hash(1)));
+
+    instance.clear();
+    BOOST_REQUIRE(!instance.saturated());
+    BOOST_REQUIRE(!instance.contains(make_hash(1)));
+}
+
+BOOST_AUTO_TEST_CASE(transaction_filter__from_data__to_data__round_trip)
+{
+    transaction_filter instance(1000);
+
+    for (uint32_t value = 0; value < 10; ++value)
+        instance.add(make_hash(value));
+
+    data_chunk data;
+    data_sink ostream(data);
+    ostream_writer sink(ostream);
+    instance.to_data(sink);
+    ostream.flush();
+
+    transaction_filter copy(1000);
+    data_source istream(data);
+    istream_reader source(istream);
+    BOOST_REQUIRE(copy.from_data(source));
+    BOOST_REQUIRE(!copy.saturated());
+    BOOST_REQUIRE_EQUAL(copy.size(), 10u);
+
+    for (uint32_t value = 0; value < 10; ++value)
+        BOOST_REQUIRE(copy.contains(make_hash(value)));
+}
+
+BOOST_AUTO_TEST_CASE(transaction_filter__from_data__size_mismatch__false_unchanged)
+{
+    transaction_filter instance(1000);
+    instance.add(make_hash(1));
+
+    data_chunk data;
+    data_sink ostream(data);
+    ostream_writer sink(ostream);
+    instance.to_data(sink);
+    ostream.flush();
+
+    transaction_filter copy(2000);
+    copy.add(make_hash(2));
+    data_source istream(data);
+    istream_reader source(istream);
+    BOOST_REQUIRE(!copy.from_data(source));
+    BOOST_REQUIRE_EQUAL(copy.size(), 1u);
+    BOOST_REQUIRE(copy.contains(make_hash(2)));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -34,7 +34,8 @@ BOOST_AUTO_TEST_CASE(transaction_pool__construct__foo__bar)
 BOOST_AUTO_TEST_CASE(transaction_pool__add_unconfirmed_transactions__empty_list__noop)
 {
     blockchain::settings blockchain_settings;
-    transaction_pool pool(blockchain_settings);
+    metrics_cache metrics(0);
+    transaction_pool pool(blockchain_settings, metrics);
 
     transaction_const_ptr_list txs;
     pool.add_unconfirmed_transactions(txs);
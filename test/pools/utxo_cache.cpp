@@ -0,0 +1,206 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <bitcoin/blockchain.hpp>
+
+using namespace bc;
+using namespace bc::blockchain;
+using namespace bc::system;
+using namespace bc::system::chain;
+
+BOOST_AUTO_TEST_SUITE(utxo_cache_tests)
+
+static const hash_digest hash1{ { 0x01 } };
+static const hash_digest hash2{ { 0x02 } };
+
+// A prevout populated as confirmed and unspent at the given height.
+static output_point make_prevout(const hash_digest& hash, uint32_t index,
+    size_t height)
+{
+    output_point point{ hash, index };
+    point.metadata.confirmed = true;
+    point.metadata.candidate_spent = false;
+    point.metadata.confirmed_spent = false;
+    point.metadata.height = height;
+    point.metadata.cache = output{ 42, {} };
+    return point;
+}
+
+static block make_block(const hash_digest& spent)
+{
+    const transaction coinbase{ 1, 0, { { { null_hash, point::null_index },
+        {}, 0 } }, { { 50, {} } } };
+    const transaction spender{ 1, 0, { { { spent, 0 }, {}, 0 } },
+        { { 1, {} }, { 2, {} } } };
+    return { {}, { coinbase, spender } };
+}
+
+// populate
+
+BOOST_AUTO_TEST_CASE(utxo_cache__populate__empty__false_miss)
+{
+    utxo_cache instance(1000);
+    const output_point point{ hash1, 0 };
+    BOOST_REQUIRE(!instance.populate(point, 10));
+    BOOST_REQUIRE_EQUAL(instance.misses(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(utxo_cache__populate__added__true_populated)
+{
+    utxo_cache instance(1000);
+    instance.add(make_prevout(hash1, 0, 5), 10, instance.sequence());
+    const output_point point{ hash1, 0 };
+    BOOST_REQUIRE(instance.populate(point, 10));
+    BOOST_REQUIRE(point.metadata.confirmed);
+    BOOST_REQUIRE(!point.metadata.confirmed_spent);
+    BOOST_REQUIRE_EQUAL(point.metadata.height, 5u);
+    BOOST_REQUIRE_EQUAL(point.metadata.cache.value(), 42u);
+    BOOST_REQUIRE_EQUAL(instance.hits(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(utxo_cache__populate__above_fork_point__false)
+{
+    utxo_cache instance(1000);
+    instance.add(make_prevout(hash1, 0, 5), 10, instance.sequence());
+    const output_point point{ hash1, 0 };
+    BOOST_REQUIRE(!instance.populate(point, 4));
+}
+
+// add
+
+BOOST_AUTO_TEST_CASE(utxo_cache__add__zero_limit__disabled)
+{
+    utxo_cache instance(0);
+    instance.add(make_prevout(hash1, 0, 5), 10, instance.sequence());
+    BOOST_REQUIRE_EQUAL(instance.size(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(utxo_cache__add__spent__not_cached)
+{
+    utxo_cache instance(1000);
+    auto prevout = make_prevout(hash1, 0, 5);
+    prevout.metadata.candidate_spent = true;
+    instance.add(prevout, 10, instance.sequence());
+    BOOST_REQUIRE_EQUAL(instance.size(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(utxo_cache__add__unconfirmed__not_cached)
+{
+    utxo_cache instance(1000);
+    auto prevout = make_prevout(hash1, 0, 5);
+    prevout.metadata.confirmed = false;
+    instance.add(prevout, 10, instance.sequence());
+    BOOST_REQUIRE_EQUAL(instance.size(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(utxo_cache__add__over_limit__oldest_evicted)
+{
+    const auto prevout = make_prevout(hash1, 0, 5);
+    utxo_cache instance(prevout.metadata.cache.serialized_size(false) + 200);
+    instance.add(prevout, 10, instance.sequence());
+    instance.add(make_prevout(hash2, 0, 5), 10, instance.sequence());
+    BOOST_REQUIRE_EQUAL(instance.size(), 1u);
+    BOOST_REQUIRE(!instance.populate(output_point{ hash1, 0 }, 10));
+    BOOST_REQUIRE(instance.populate(output_point{ hash2, 0 }, 10));
+}
+
+BOOST_AUTO_TEST_CASE(utxo_cache__add__removal_since_sequence__not_cached)
+{
+    utxo_cache instance(10000);
+    const auto sequence = instance.sequence();
+    instance.remove_spent(make_block(hash2));
+    instance.add(make_prevout(hash1, 0, 5), 10, sequence);
+    BOOST_REQUIRE_EQUAL(instance.size(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(utxo_cache__add_block__outputs_cached)
+{
+    utxo_cache instance(10000);
+    const auto value = make_block(hash1);
+    instance.add(value, 7);
+    BOOST_REQUIRE_EQUAL(instance.size(), 3u);
+
+    const output_point coinbase{ value.transactions()[0].hash(), 0 };
+    BOOST_REQUIRE(instance.populate(coinbase, 7));
+    BOOST_REQUIRE(coinbase.metadata.coinbase);
+    BOOST_REQUIRE_EQUAL(coinbase.metadata.height, 7u);
+
+    const output_point change{ value.transactions()[1].hash(), 1 };
+    BOOST_REQUIRE(instance.populate(change, 7));
+    BOOST_REQUIRE(!change.metadata.coinbase);
+    BOOST_REQUIRE_EQUAL(change.metadata.cache.value(), 2u);
+}
+
+BOOST_AUTO_TEST_CASE(utxo_cache__add_block__spent_in_block__not_cached)
+{
+    utxo_cache instance(10000);
+    const auto value = make_block(hash1);
+    const auto& funding = value.transactions()[1];
+    const transaction spender{ 1, 0, { { { funding.hash(), 0 }, {}, 0 } },
+        { { 3, {} } } };
+    const block both{ {}, { value.transactions()[0], funding, spender } };
+    instance.add(both, 7);
+
+    // The output created and spent within the block is not cached.
+    BOOST_REQUIRE_EQUAL(instance.size(), 3u);
+    BOOST_REQUIRE(!instance.populate(output_point{ funding.hash(), 0 }, 7));
+    BOOST_REQUIRE(instance.populate(output_point{ funding.hash(), 1 }, 7));
+    BOOST_REQUIRE(instance.populate(output_point{ spender.hash(), 0 }, 7));
+}
+
+BOOST_AUTO_TEST_CASE(utxo_cache__add_block__unspendable__not_cached)
+{
+    script unspendable;
+    BOOST_REQUIRE(unspendable.from_string("return"));
+    BOOST_REQUIRE(unspendable.is_unspendable());
+
+    utxo_cache instance(10000);
+    const transaction coinbase{ 1, 0, { { { null_hash, point::null_index },
+        {}, 0 } }, { { 50, {} }, { 0, unspendable } } };
+    instance.add(block{ {}, { coinbase } }, 7);
+
+    BOOST_REQUIRE_EQUAL(instance.size(), 1u);
+    BOOST_REQUIRE(instance.populate(output_point{ coinbase.hash(), 0 }, 7));
+    BOOST_REQUIRE(!instance.populate(output_point{ coinbase.hash(), 1 }, 7));
+}
+
+// remove
+
+BOOST_AUTO_TEST_CASE(utxo_cache__remove_spent__cached__removed)
+{
+    utxo_cache instance(10000);
+    instance.add(make_prevout(hash1, 0, 5), 10, instance.sequence());
+    instance.remove_spent(make_block(hash1));
+    BOOST_REQUIRE_EQUAL(instance.size(), 0u);
+    BOOST_REQUIRE_EQUAL(instance.bytes(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(utxo_cache__remove_created__block__removed)
+{
+    utxo_cache instance(10000);
+    const auto value = make_block(hash1);
+    instance.add(make_prevout(hash2, 0, 5), 10, instance.sequence());
+    instance.add(value, 7);
+    instance.remove_created(value);
+    BOOST_REQUIRE_EQUAL(instance.size(), 1u);
+    BOOST_REQUIRE(instance.populate(output_point{ hash2, 0 }, 10));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
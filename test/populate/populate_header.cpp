@@ -0,0 +1,106 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <memory>
+#include <bitcoin/blockchain.hpp>
+#include "../utility.hpp"
+
+using namespace bc;
+using namespace bc::system;
+using namespace bc::blockchain;
+
+using test::block_chain_accessor;
+
+namespace {
+
+// A header of the given nonce, with mainnet block 2 difficulty.
+header_const_ptr make_header(uint32_t nonce, const hash_digest& parent)
+{
+    static const uint32_t bits = 0x1d00ffff;
+    static const uint32_t timestamp = 1231470000;
+    return std::make_shared<const message::header>(chain::header
+    {
+        1, parent, null_hash, timestamp, bits, nonce
+    });
+}
+
+} // namespace
+
+// Starts a chain with mainnet blocks 1 and 2 as candidates, a populator and a
+// header pool with header 3 internal (stateless) below its child, header 4.
+#define START_POPULATOR(name, parent) \
+    START_BLOCKCHAIN(chain, false, false); \
+    BOOST_REQUIRE(test::push_candidates(chain)); \
+    threadpool priority(1); \
+    dispatcher dispatch(priority, TEST_NAME); \
+    populate_header name(dispatch, chain); \
+    header_pool headers(blockchain_settings); \
+    const auto block2 = NEW_BLOCK(2); \
+    const auto header3 = make_header(3, parent); \
+    const auto header4 = make_header(4, header3->hash()); \
+    header3->metadata.state = chain.promote_state(*header3, \
+        chain.chain_state(block2->header(), 2)); \
+    header4->metadata.state = chain.promote_state(*header4, \
+        header3->metadata.state); \
+    headers.add(header3, 3); \
+    headers.add(header4, 4); \
+    BOOST_REQUIRE(!header3->metadata.state)
+
+BOOST_FIXTURE_TEST_SUITE(populate_header_tests, test::setup_fixture)
+
+BOOST_AUTO_TEST_CASE(populate_header__populate__branch_off_internal_node__state_rebuilt)
+{
+    START_POPULATOR(instance, NEW_BLOCK(2)->hash());
+
+    // A sibling of header 4 branches off of the internal header 3.
+    const auto sibling = make_header(42, header3->hash());
+    const auto branch = headers.get_branch(sibling);
+    BOOST_REQUIRE_EQUAL(branch->size(), 2u);
+
+    code result(error::operation_failed);
+    instance.populate(branch, [&](const code& ec) { result = ec; });
+    BOOST_REQUIRE_EQUAL(result, error::success);
+
+    // State is promoted from the fork point (block 2) through header 3.
+    const auto state = sibling->metadata.state;
+    BOOST_REQUIRE(state);
+    BOOST_REQUIRE_EQUAL(state->height(), 4u);
+    BOOST_REQUIRE(state->hash() == sibling->hash());
+
+    // The internal header does not regain chain state.
+    BOOST_REQUIRE(!header3->metadata.state);
+}
+
+BOOST_AUTO_TEST_CASE(populate_header__populate__branch_off_internal_node_not_grounded__orphan)
+{
+    START_POPULATOR(instance, hash_digest{ { 42 } });
+
+    // The branch fork point is not in the candidate index.
+    const auto sibling = make_header(42, header3->hash());
+    const auto branch = headers.get_branch(sibling);
+    BOOST_REQUIRE_EQUAL(branch->size(), 2u);
+
+    code result(error::success);
+    instance.populate(branch, [&](const code& ec) { result = ec; });
+    BOOST_REQUIRE_EQUAL(result, error::orphan_block);
+    BOOST_REQUIRE(!sibling->metadata.state);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
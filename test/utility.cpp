@@ -16,8 +16,9 @@
  * You should have received a copy of the GNU Affero General Public License
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
-#include <boost/test/unit_test.hpp>
+#include "utility.hpp"
 
+#include <memory>
 #include <string>
 #include <boost/filesystem.hpp>
 #include <bitcoin/blockchain.hpp>
@@ -31,6 +32,29 @@ using namespace boost::filesystem;
 
 namespace test {
 
+block_chain_accessor::block_chain_accessor(threadpool& pool,
+    const blockchain::settings& settings,
+    const database::settings& database_settings,
+    const system::settings& bitcoin_settings)
+  : block_chain(pool, settings, database_settings, bitcoin_settings)
+{
+}
+
+data_base& block_chain_accessor::database()
+{
+    return database_;
+}
+
+setup_fixture::setup_fixture()
+{
+    remove_test_directory(TEST_NAME);
+}
+
+setup_fixture::~setup_fixture()
+{
+    remove_test_directory(TEST_NAME);
+}
+
 chain::block read_block(const std::string& hex)
 {
     data_chunk data;
@@ -40,10 +64,37 @@ chain::block read_block(const std::string& hex)
     return result;
 }
 
+// Make mainnet blocks 1 and 2 the candidate chain above genesis.
+bool push_candidates(data_base& database)
+{
+    const system::settings bitcoin_settings(config::settings::mainnet);
+    const auto& genesis = bitcoin_settings.genesis_block;
+    const auto incoming = std::make_shared<const header_const_ptr_list>(
+        header_const_ptr_list
+        {
+            std::make_shared<const message::header>(NEW_BLOCK(1)->header()),
+            std::make_shared<const message::header>(NEW_BLOCK(2)->header())
+        });
+
+    const auto outgoing = std::make_shared<header_const_ptr_list>();
+    return !database.reorganize({ genesis.hash(), 0 }, incoming, outgoing);
+}
+
+bool push_candidates(block_chain_accessor& instance)
+{
+    return push_candidates(instance.database());
+}
+
 bool create_database(database::settings& out_database, bool index_payments)
 {
     static const auto mainnet = config::settings::mainnet;
+    return create_database(out_database, index_payments,
+        system::settings(mainnet).genesis_block);
+}
 
+bool create_database(database::settings& out_database, bool index_payments,
+    const chain::block& genesis)
+{
     // Table optimization parameters, reduced for speed and more collision.
     out_database.file_growth_rate = 42;
     out_database.block_table_buckets = 42;
@@ -54,7 +105,7 @@ bool create_database(database::settings& out_database, bool index_payments)
     remove_all(out_database.directory, ec);
     database::data_base database(out_database, index_payments, false);
     return create_directories(out_database.directory, ec) &&
-        database.create(system::settings(mainnet).genesis_block);
+        database.create(genesis);
 }
 
 void remove_test_directory(std::string directory)
@@ -16,6 +16,9 @@
  * You should have received a copy of the GNU Affero General Public License
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
+#ifndef LIBBITCOIN_BLOCKCHAIN_TEST_UTILITY_HPP
+#define LIBBITCOIN_BLOCKCHAIN_TEST_UTILITY_HPP
+
 #include <boost/test/unit_test.hpp>
 
 #include <string>
@@ -66,9 +69,36 @@
 
 namespace test {
 
+// The block_chain test accessor, used by START_BLOCKCHAIN where in scope.
+class block_chain_accessor
+  : public bc::blockchain::block_chain
+{
+public:
+    block_chain_accessor(bc::system::threadpool& pool,
+        const bc::blockchain::settings& settings,
+        const bc::database::settings& database_settings,
+        const bc::system::settings& bitcoin_settings);
+
+    bc::database::data_base& database();
+};
+
+// Removes the test directory before and after each test case.
+class setup_fixture
+{
+public:
+    setup_fixture();
+    ~setup_fixture();
+};
+
 bc::system::chain::block read_block(const std::string& hex);
+bool push_candidates(bc::database::data_base& database);
+bool push_candidates(block_chain_accessor& instance);
 bool create_database(bc::database::settings& out_database, bool index_payments);
+bool create_database(bc::database::settings& out_database, bool index_payments,
+    const bc::system::chain::block& genesis);
 void remove_test_directory(std::string name);
 bc::system::chain::transaction random_tx(uint32_t fudge);
 
 } // namespace test
+
+#endif
@@ -0,0 +1,106 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <bitcoin/blockchain.hpp>
+
+using namespace bc;
+using namespace bc::blockchain;
+using namespace bc::system;
+using namespace bc::system::chain;
+
+BOOST_AUTO_TEST_SUITE(metrics_cache_tests)
+
+static const auto version = message::version::level::canonical;
+
+static message::transaction make_tx(uint32_t locktime)
+{
+    return { 1, locktime, {}, {} };
+}
+
+// find
+
+BOOST_AUTO_TEST_CASE(metrics_cache__find__empty__false_miss)
+{
+    metrics_cache instance(10);
+    metrics_cache::metrics out;
+    BOOST_REQUIRE(!instance.find(out, make_tx(1), true, true));
+    BOOST_REQUIRE_EQUAL(instance.hits(), 0u);
+    BOOST_REQUIRE_EQUAL(instance.misses(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(metrics_cache__find__added__true_expected)
+{
+    metrics_cache instance(10);
+    const auto tx = make_tx(1);
+    instance.add(tx, true, true);
+    metrics_cache::metrics out;
+    BOOST_REQUIRE(instance.find(out, tx, true, true));
+    BOOST_REQUIRE_EQUAL(out.size, tx.serialized_size(version));
+    BOOST_REQUIRE_EQUAL(out.sigops, tx.signature_operations(true, true));
+}
+
+BOOST_AUTO_TEST_CASE(metrics_cache__find__other_rules__false)
+{
+    metrics_cache instance(10);
+    const auto tx = make_tx(1);
+    instance.add(tx, true, true);
+    metrics_cache::metrics out;
+    BOOST_REQUIRE(!instance.find(out, tx, true, false));
+    BOOST_REQUIRE(!instance.find(out, tx, false, true));
+}
+
+// add
+
+BOOST_AUTO_TEST_CASE(metrics_cache__add__zero_limit__computed_not_cached)
+{
+    metrics_cache instance(0);
+    const auto tx = make_tx(1);
+    const auto result = instance.add(tx, true, true);
+    BOOST_REQUIRE_EQUAL(result.size, tx.serialized_size(version));
+    BOOST_REQUIRE_EQUAL(instance.size(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(metrics_cache__add__duplicate__single_hit)
+{
+    metrics_cache instance(10);
+    const auto tx = make_tx(1);
+    instance.add(tx, true, true);
+    instance.add(tx, true, true);
+    BOOST_REQUIRE_EQUAL(instance.size(), 1u);
+    BOOST_REQUIRE_EQUAL(instance.hits(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(metrics_cache__add__over_limit__oldest_evicted)
+{
+    metrics_cache instance(2);
+    const auto tx1 = make_tx(1);
+    const auto tx2 = make_tx(2);
+    const auto tx3 = make_tx(3);
+    instance.add(tx1, true, true);
+    instance.add(tx2, true, true);
+    instance.add(tx3, true, true);
+    metrics_cache::metrics out;
+    BOOST_REQUIRE_EQUAL(instance.size(), 2u);
+    BOOST_REQUIRE(!instance.find(out, tx1, true, true));
+    BOOST_REQUIRE(instance.find(out, tx2, true, true));
+    BOOST_REQUIRE(instance.find(out, tx3, true, true));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,116 @@
+/**
+ * Copyright (c) 2011-2019 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <bitcoin/blockchain.hpp>
+
+using namespace bc;
+using namespace bc::blockchain;
+using namespace bc::system;
+using namespace bc::system::chain;
+using namespace bc::system::machine;
+
+BOOST_AUTO_TEST_SUITE(script_cache_tests)
+
+static const uint32_t forks = rule_fork::bip16_rule | rule_fork::bip141_rule;
+
+static transaction make_tx(uint32_t locktime)
+{
+    return { 1, locktime, {}, {} };
+}
+
+// find
+
+BOOST_AUTO_TEST_CASE(script_cache__find__empty__false_miss)
+{
+    script_cache instance(10);
+    BOOST_REQUIRE(!instance.find(make_tx(1), 0, forks));
+    BOOST_REQUIRE_EQUAL(instance.hits(), 0u);
+    BOOST_REQUIRE_EQUAL(instance.misses(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(script_cache__find__added__true_hit)
+{
+    script_cache instance(10);
+    const auto tx = make_tx(1);
+    instance.add(tx, 0, forks);
+    BOOST_REQUIRE(instance.find(tx, 0, forks));
+    BOOST_REQUIRE_EQUAL(instance.hits(), 1u);
+    BOOST_REQUIRE_EQUAL(instance.misses(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(script_cache__find__other_input__false)
+{
+    script_cache instance(10);
+    const auto tx = make_tx(1);
+    instance.add(tx, 0, forks);
+    BOOST_REQUIRE(!instance.find(tx, 1, forks));
+}
+
+BOOST_AUTO_TEST_CASE(script_cache__find__other_forks__false)
+{
+    script_cache instance(10);
+    const auto tx = make_tx(1);
+    instance.add(tx, 0, forks);
+    BOOST_REQUIRE(!instance.find(tx, 0, rule_fork::bip16_rule));
+}
+
+BOOST_AUTO_TEST_CASE(script_cache__find__other_tx__false)
+{
+    script_cache instance(10);
+    instance.add(make_tx(1), 0, forks);
+    BOOST_REQUIRE(!instance.find(make_tx(2), 0, forks));
+}
+
+// add
+
+BOOST_AUTO_TEST_CASE(script_cache__add__zero_limit__disabled)
+{
+    script_cache instance(0);
+    const auto tx = make_tx(1);
+    instance.add(tx, 0, forks);
+    BOOST_REQUIRE_EQUAL(instance.size(), 0u);
+    BOOST_REQUIRE(!instance.find(tx, 0, forks));
+}
+
+BOOST_AUTO_TEST_CASE(script_cache__add__duplicate__single)
+{
+    script_cache instance(10);
+    const auto tx = make_tx(1);
+    instance.add(tx, 0, forks);
+    instance.add(tx, 0, forks);
+    BOOST_REQUIRE_EQUAL(instance.size(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(script_cache__add__over_limit__oldest_evicted)
+{
+    script_cache instance(2);
+    const auto tx1 = make_tx(1);
+    const auto tx2 = make_tx(2);
+    const auto tx3 = make_tx(3);
+    instance.add(tx1, 0, forks);
+    instance.add(tx2, 0, forks);
+    instance.add(tx3, 0, forks);
+    BOOST_REQUIRE_EQUAL(instance.size(), 2u);
+    BOOST_REQUIRE(!instance.find(tx1, 0, forks));
+    BOOST_REQUIRE(instance.find(tx2, 0, forks));
+    BOOST_REQUIRE(instance.find(tx3, 0, forks));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
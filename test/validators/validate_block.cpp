@@ -18,6 +18,7 @@
  */
 #include <boost/test/unit_test.hpp>
 #include <bitcoin/blockchain.hpp>
+#include "../utility.hpp"
 
 using namespace bc;
 using namespace bc::blockchain;
@@ -25,7 +26,32 @@ using namespace bc::system;
 using namespace bc::system::chain;
 using namespace bc::system::machine;
 
-BOOST_AUTO_TEST_SUITE(validate_block_tests)
+using test::block_chain_accessor;
+
+namespace {
+
+class validate_block_accessor
+  : public validate_block
+{
+public:
+    validate_block_accessor(dispatcher& dispatch, const fast_chain& chain,
+        const script_cache& cache, const metrics_cache& metrics,
+        const blockchain::settings& settings,
+        const system::settings& bitcoin_settings)
+      : validate_block(dispatch, chain, cache, metrics, settings,
+          bitcoin_settings)
+    {
+    }
+
+    bool is_assumed_valid(size_t height) const
+    {
+        return validate_block::is_assumed_valid(height);
+    }
+};
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(validate_block_tests, test::setup_fixture)
 
 #ifdef WITH_CONSENSUS
     static const auto libconsensus = true;
@@ -68,4 +94,82 @@ BOOST_AUTO_TEST_CASE(validate_block__native__block_438513_tx__valid)
     BOOST_REQUIRE_EQUAL(result.value(), error::success);
 }
 
+// is_assumed_valid
+
+BOOST_AUTO_TEST_CASE(validate_block__is_assumed_valid__unconfigured__false)
+{
+    START_BLOCKCHAIN(instance, false, false);
+    BOOST_REQUIRE(test::push_candidates(instance));
+
+    dispatcher dispatch(pool, TEST_NAME);
+    const script_cache scripts(0);
+    const metrics_cache metrics(0);
+    const blockchain::settings settings;
+    validate_block_accessor validator(dispatch, instance, scripts, metrics,
+        settings, bitcoin_settings);
+
+    BOOST_REQUIRE(!validator.is_assumed_valid(0));
+    BOOST_REQUIRE(!validator.is_assumed_valid(1));
+    BOOST_REQUIRE(!validator.is_assumed_valid(2));
+}
+
+BOOST_AUTO_TEST_CASE(validate_block__is_assumed_valid__at_or_below_candidate__true)
+{
+    START_BLOCKCHAIN(instance, false, false);
+    BOOST_REQUIRE(test::push_candidates(instance));
+
+    dispatcher dispatch(pool, TEST_NAME);
+    const script_cache scripts(0);
+    const metrics_cache metrics(0);
+    blockchain::settings settings;
+    settings.assume_valid = { NEW_BLOCK(2)->hash(), 2 };
+    validate_block_accessor validator(dispatch, instance, scripts, metrics,
+        settings, bitcoin_settings);
+
+    // Scripts are skipped at and below the assumed valid candidate.
+    BOOST_REQUIRE(validator.is_assumed_valid(1));
+    BOOST_REQUIRE(validator.is_assumed_valid(2));
+
+    // Scripts are validated above the assumed valid block.
+    BOOST_REQUIRE(!validator.is_assumed_valid(3));
+}
+
+BOOST_AUTO_TEST_CASE(validate_block__is_assumed_valid__different_candidate__false)
+{
+    START_BLOCKCHAIN(instance, false, false);
+    BOOST_REQUIRE(test::push_candidates(instance));
+
+    dispatcher dispatch(pool, TEST_NAME);
+    const script_cache scripts(0);
+    const metrics_cache metrics(0);
+    blockchain::settings settings;
+
+    // The candidate at height 2 is not the assumed valid block.
+    settings.assume_valid = { NEW_BLOCK(1)->hash(), 2 };
+    validate_block_accessor validator(dispatch, instance, scripts, metrics,
+        settings, bitcoin_settings);
+
+    BOOST_REQUIRE(!validator.is_assumed_valid(1));
+    BOOST_REQUIRE(!validator.is_assumed_valid(2));
+}
+
+BOOST_AUTO_TEST_CASE(validate_block__is_assumed_valid__above_candidate_top__false)
+{
+    START_BLOCKCHAIN(instance, false, false);
+    BOOST_REQUIRE(test::push_candidates(instance));
+
+    dispatcher dispatch(pool, TEST_NAME);
+    const script_cache scripts(0);
+    const metrics_cache metrics(0);
+    blockchain::settings settings;
+
+    // The assumed valid block is not yet a candidate.
+    settings.assume_valid = { NEW_BLOCK(3)->hash(), 3 };
+    validate_block_accessor validator(dispatch, instance, scripts, metrics,
+        settings, bitcoin_settings);
+
+    BOOST_REQUIRE(!validator.is_assumed_valid(1));
+    BOOST_REQUIRE(!validator.is_assumed_valid(3));
+}
+
 BOOST_AUTO_TEST_SUITE_END()